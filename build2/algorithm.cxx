@@ -4,12 +4,17 @@
 
 #include <build2/algorithm.hxx>
 
+#include <map>
+#include <sstream>
+
 #include <build2/scope.hxx>
 #include <build2/target.hxx>
 #include <build2/rule.hxx>
-#include <build2/file.hxx> // import()
+#include <build2/file.hxx> // import(), load_deferred()
 #include <build2/search.hxx>
 #include <build2/context.hxx>
+#include <build2/timeline.hxx>
+#include <build2/durations.hxx>
 #include <build2/filesystem.hxx>
 #include <build2/diagnostics.hxx>
 #include <build2/prerequisite.hxx>
@@ -30,6 +35,23 @@ namespace build2
     if (pk.proj)
       return import (pk);
 
+    // In the load on demand mode the buildfile that defines this target may
+    // not have been loaded yet.
+    //
+    if (load_on_demand && !pk.tk.dir->empty ())
+    {
+      const dir_path& d (*pk.tk.dir);
+
+      if (d.absolute ())
+        load_deferred (d);
+      else if (pk.scope != nullptr)
+      {
+        dir_path out_base (pk.scope->out_path () / d);
+        out_base.normalize ();
+        load_deferred (out_base);
+      }
+    }
+
     if (const target* pt = pk.tk.type->search (t, pk))
       return *pt;
 
@@ -102,6 +124,63 @@ namespace build2
     return q ? import_existing (pk) : search_existing_target (pk);
   }
 
+  // Target wait statistics.
+  //
+  static std::map<const target_type*, target_wait_stat> target_wait_stats;
+  static mutex target_wait_stats_mutex;
+
+  vector<target_wait_stat>
+  target_wait_statistics ()
+  {
+    vector<target_wait_stat> r;
+    {
+      mlock l (target_wait_stats_mutex);
+
+      for (const auto& p: target_wait_stats)
+        r.push_back (p.second);
+    }
+
+    sort (r.begin (), r.end (),
+          [] (const target_wait_stat& x, const target_wait_stat& y)
+          {
+            return x.suspends > y.suspends;
+          });
+
+    return r;
+  }
+
+  // Wait on the target's task count (see scheduler::wait()) attributing the
+  // suspension, if any, to the target type.
+  //
+  static size_t
+  wait_target (const target& t,
+               size_t start_count,
+               const atomic_count& tc,
+               scheduler::work_queue wq)
+  {
+    size_t n (scheduler::thread_wait_stat ().suspends);
+    size_t r (sched.wait (start_count, tc, wq));
+    scheduler::wait_stat s (scheduler::thread_wait_stat ());
+
+    // Note that while waiting we may have executed tasks from our queue
+    // which themselves may have suspended. But if this wait suspended, then
+    // that would be the last suspension (the queue is worked first).
+    //
+    if (s.suspends != n && s.task_count == &tc)
+    {
+      mlock l (target_wait_stats_mutex);
+
+      target_wait_stat& ws (target_wait_stats[&t.type ()]);
+      ws.type = &t.type ();
+      ws.suspends++;
+
+      if (s.collision)
+        ws.collisions++;
+    }
+
+    return r;
+  }
+
   // target_lock
   //
 #ifdef __cpp_thread_local
@@ -157,7 +236,7 @@ namespace build2
         // unless we release the phase.
         //
         phase_unlock ul;
-        e = sched.wait (busy - 1, task_count, *wq);
+        e = wait_target (ct, busy - 1, task_count, *wq);
       }
 
       // We don't lock already applied or executed targets.
@@ -399,6 +478,16 @@ namespace build2
     return r.second.get ().apply (a, t);
   }
 
+  // Return the timeline event name for the action on the target.
+  //
+  static string
+  timeline_name (action a, const target& t)
+  {
+    ostringstream os;
+    os << diag_do (a, t);
+    return os.str ();
+  }
+
   // If step is true then perform only one step of the match/apply sequence.
   //
   // If try_match is true, then indicate whether there is a rule match with
@@ -415,6 +504,10 @@ namespace build2
     target& t (*l.target);
     target::opstate& s (t[a]);
 
+    timeline_span ts ("match");
+    if (ts)
+      ts.name = timeline_name (a, t);
+
     try
     {
       // Continue from where the target has been left off.
@@ -467,6 +560,9 @@ namespace build2
         {
           // Apply.
           //
+          if (ts)
+            ts.args.push_back (make_pair ("rule", s.rule->first));
+
           set_recipe (l, apply_impl (a, t, *s.rule));
           l.offset = target::offset_applied;
           break;
@@ -643,7 +739,7 @@ namespace build2
         // to execute it now.
         //
         {
-          phase_switch ps (run_phase::execute);
+          phase_switch ps (run_phase::execute, &g);
           execute_direct (a, g);
         }
 
@@ -1405,6 +1501,10 @@ namespace build2
     target_state ts;
     try
     {
+      timeline_span tls ("execute");
+      if (tls)
+        tls.name = timeline_name (a, t);
+
       // Handle target backlinking to forwarded configurations.
       //
       // Note that this function will never be called if the recipe is noop
@@ -1422,8 +1522,29 @@ namespace build2
           backlink_clean_pre (a, t, *blm);
       }
 
+      // Record the duration of the update for the next run's scheduling
+      // (see execution_order() below).
+      //
+      const path_target* pt (a == perform_update_id
+                             ? t.is_a<path_target> ()
+                             : nullptr);
+
+      timestamp st (pt != nullptr ? system_clock::now () : timestamp ());
+
       ts = execute_recipe (a, t, s.recipe);
 
+      if (pt != nullptr && ts == target_state::changed)
+      {
+        const path& p (pt->path ());
+
+        if (!p.empty ())
+        {
+          if (const scope* rs = t.base_scope ().root_scope ())
+            durations::instance (*rs).insert (
+              p, system_clock::now () - st);
+        }
+      }
+
       if (blm)
       {
         if (a == perform_update_id)
@@ -1597,8 +1718,10 @@ namespace build2
     {
         // If the target is busy, wait for it.
         //
-        if (tc >= busy) sched.wait (exec, s.task_count, scheduler::work_none);
-        else            assert (tc == exec);
+        if (tc >= busy)
+          wait_target (t, exec, s.task_count, scheduler::work_none);
+        else
+          assert (tc == exec);
     }
 
     return t.executed_state (a);
@@ -1619,6 +1742,76 @@ namespace build2
     return pt.adhoc;
   }
 
+  // Return the order in which to start the asynchronous execution of the
+  // targets in [b, e): those that took the longest to update in the
+  // previous run first with the rest in the declaration order. Since the
+  // helper threads take tasks from the front of the queue, this way the
+  // targets on the critical path are started first. Return empty if the
+  // declaration order should be used.
+  //
+  // The durations are looked up in the database of the project of the
+  // target r (or the first target if NULL).
+  //
+  using execution_order_type = small_vector<size_t, 16>;
+
+  template <typename T>
+  static execution_order_type
+  execution_order (action a, const target* r, T ts[], size_t b, size_t e)
+  {
+    execution_order_type o;
+
+    if (a != perform_update_id || sched.serial () || e - b < 2)
+      return o;
+
+    const durations* db (nullptr);
+    small_vector<pair<uint64_t, size_t>, 16> ds;
+    size_t k (0); // Number of known durations.
+
+    for (size_t i (b); i != e; ++i)
+    {
+      const target* t (ts[i]);
+
+      if (t == nullptr)
+        continue;
+
+      if (db == nullptr)
+      {
+        const scope* rs ((r != nullptr ? *r : *t).base_scope ().root_scope ());
+
+        if (rs == nullptr)
+          return o;
+
+        db = &durations::instance (*rs);
+      }
+
+      uint64_t d (0);
+      if (const path_target* pt = t->is_a<path_target> ())
+      {
+        const path& p (pt->path ());
+
+        if (!p.empty () && (d = db->find (p)) != 0)
+          ++k;
+      }
+
+      ds.push_back (make_pair (d, i));
+    }
+
+    if (k == 0 || ds.size () < 2)
+      return o;
+
+    stable_sort (ds.begin (), ds.end (),
+                 [] (const pair<uint64_t, size_t>& x,
+                     const pair<uint64_t, size_t>& y)
+                 {
+                   return x.first > y.first;
+                 });
+
+    for (const pair<uint64_t, size_t>& d: ds)
+      o.push_back (d.second);
+
+    return o;
+  }
+
   template <typename T>
   target_state
   straight_execute_members (action a, atomic_count& tc,
@@ -1631,13 +1824,9 @@ namespace build2
     wait_guard wg (target::count_busy (), tc);
 
     n += p;
-    for (size_t i (p); i != n; ++i)
-    {
-      const target*& mt (ts[i]);
-
-      if (mt == nullptr) // Skipped.
-        continue;
 
+    auto start = [a, &tc, &r] (const target*& mt)
+    {
       target_state s (execute_async (a, *mt, target::count_busy (), tc));
 
       if (s == target_state::postponed)
@@ -1645,6 +1834,26 @@ namespace build2
         r |= s;
         mt = nullptr;
       }
+    };
+
+    execution_order_type o (execution_order (a, nullptr, ts, p, n));
+
+    if (!o.empty ())
+    {
+      for (size_t i: o)
+        start (ts[i]);
+    }
+    else
+    {
+      for (size_t i (p); i != n; ++i)
+      {
+        const target*& mt (ts[i]);
+
+        if (mt == nullptr) // Skipped.
+          continue;
+
+        start (mt);
+      }
     }
 
     wg.wait ();
@@ -1664,7 +1873,7 @@ namespace build2
       //
       const auto& tc (mt[a].task_count);
       if (tc.load (memory_order_acquire) >= target::count_busy ())
-        sched.wait (target::count_executed (), tc, scheduler::work_none);
+        wait_target (mt, target::count_executed (), tc, scheduler::work_none);
 
       r |= mt.executed_state (a);
 
@@ -1713,7 +1922,7 @@ namespace build2
 
       const auto& tc (mt[a].task_count);
       if (tc.load (memory_order_acquire) >= target::count_busy ())
-        sched.wait (target::count_executed (), tc, scheduler::work_none);
+        wait_target (mt, target::count_executed (), tc, scheduler::work_none);
 
       r |= mt.executed_state (a);
 
@@ -1760,13 +1969,8 @@ namespace build2
 
     wait_guard wg (target::count_busy (), t[a].task_count);
 
-    for (size_t i (0); i != n; ++i)
+    auto start = [a, &t, &rs] (const target*& pt)
     {
-      const target*& pt (pts[i]);
-
-      if (pt == nullptr) // Skipped.
-        continue;
-
       target_state s (
         execute_async (
           a, *pt, target::count_busy (), t[a].task_count));
@@ -1776,6 +1980,26 @@ namespace build2
         rs |= s;
         pt = nullptr;
       }
+    };
+
+    execution_order_type o (execution_order (a, &t, pts.data (), 0, n));
+
+    if (!o.empty ())
+    {
+      for (size_t i: o)
+        start (pts[i]);
+    }
+    else
+    {
+      for (size_t i (0); i != n; ++i)
+      {
+        const target*& pt (pts[i]);
+
+        if (pt == nullptr) // Skipped.
+          continue;
+
+        start (pt);
+      }
     }
 
     wg.wait ();
@@ -1792,7 +2016,7 @@ namespace build2
 
       const auto& tc (pt[a].task_count);
       if (tc.load (memory_order_acquire) >= target::count_busy ())
-        sched.wait (target::count_executed (), tc, scheduler::work_none);
+        wait_target (pt, target::count_executed (), tc, scheduler::work_none);
 
       target_state s (pt.executed_state (a));
       rs |= s;
@@ -1854,9 +2078,10 @@ namespace build2
     target_state gs (execute (a, g));
 
     if (gs == target_state::busy)
-      sched.wait (target::count_executed (),
-                  g[a].task_count,
-                  scheduler::work_none);
+      wait_target (g,
+                   target::count_executed (),
+                   g[a].task_count,
+                   scheduler::work_none);
 
     // Return target_state::group to signal to execute() that this target's
     // state comes from the group (which, BTW, can be failed).
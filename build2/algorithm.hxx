@@ -702,6 +702,26 @@ namespace build2
   clean_backlink (const path& link,
                   uint16_t verbosity,
                   backlink_mode = backlink_mode::link);
+
+  // Target wait statistics (printed with --stat).
+  //
+  // The number of times a thread had to suspend waiting for another thread
+  // to finish matching or executing a target and how many of those
+  // suspensions shared the scheduler's wait slot with threads waiting for
+  // unrelated targets. Recorded per target type.
+  //
+  struct target_wait_stat
+  {
+    const target_type* type = nullptr;
+    size_t suspends = 0;
+    size_t collisions = 0;
+  };
+
+  // Return a snapshot of the statistics, most suspensions first. Thread-
+  // safe.
+  //
+  vector<target_wait_stat>
+  target_wait_statistics ();
 }
 
 #include <build2/algorithm.ixx>
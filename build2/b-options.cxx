@@ -601,6 +601,9 @@ namespace build2
     verbose_ (1),
     verbose_specified_ (false),
     stat_ (),
+    mem_stat_ (),
+    trace_file_ (),
+    trace_file_specified_ (false),
     dump_ (),
     dump_specified_ (false),
     jobs_ (),
@@ -616,6 +619,7 @@ namespace build2
     no_mtime_check_ (),
     structured_result_ (),
     match_only_ (),
+    load_on_demand_ (),
     no_column_ (),
     no_line_ (),
     buildfile_ ("buildfile"),
@@ -743,6 +747,24 @@ namespace build2
     os << std::endl
        << "\033[1m--stat\033[0m               Display build statistics." << ::std::endl;
 
+    os << std::endl
+       << "\033[1m--mem-stat\033[0m           Print memory usage broken down by subsystem to" << ::std::endl
+       << "                     \033[1mstdout\033[0m once the build is complete. For each subsystem" << ::std::endl
+       << "                     one line is printed in the \033[1mmem \033[4msubsystem\033[0m \033[4mlive\033[0m \033[4mpeak\033[0m" << ::std::endl
+       << "                     \033[4mallocations\033[0m \033[4mbytes\033[0m form where \033[4mlive\033[0m and \033[4mpeak\033[0m are the" << ::std::endl
+       << "                     current and maximum number of bytes used by its" << ::std::endl
+       << "                     containers and \033[4mallocations\033[0m and \033[4mbytes\033[0m are the number of" << ::std::endl
+       << "                     heap allocations and the total number of bytes" << ::std::endl
+       << "                     allocated while performing its work." << ::std::endl;
+
+    os << std::endl
+       << "\033[1m--trace-file\033[0m \033[4mfile\033[0m    Write the build timeline to the specified file in the" << ::std::endl
+       << "                     Chrome trace event format that can be viewed with" << ::std::endl
+       << "                     \033[1mchrome://tracing\033[0m or Perfetto. The timeline includes the" << ::std::endl
+       << "                     loading of buildfiles, rule matching and recipe" << ::std::endl
+       << "                     execution for each target, external program runs," << ::std::endl
+       << "                     dependency database I/O, and phase switches." << ::std::endl;
+
     os << std::endl
        << "\033[1m--dump\033[0m \033[4mphase\033[0m         Dump the build system state after the specified phase." << ::std::endl
        << "                     Valid \033[4mphase\033[0m values are \033[1mload\033[0m (after loading \033[1mbuildfiles\033[0m) and" << ::std::endl
@@ -827,6 +849,15 @@ namespace build2
        << "\033[1m--match-only\033[0m         Match the rules but do not execute the operation. This" << ::std::endl
        << "                     mode is primarily useful for profiling." << ::std::endl;
 
+    os << std::endl
+       << "\033[1m--load-on-demand\033[0m     Do not load subdirectory buildfiles mentioned in the" << ::std::endl
+       << "                     \033[1minclude\033[0m directive immediately but rather wait until a" << ::std::endl
+       << "                     target in such a directory is searched for during match." << ::std::endl
+       << "                     This mode can significantly reduce the load time when" << ::std::endl
+       << "                     building a small part of a large project. Note, however," << ::std::endl
+       << "                     that it is only safe if such buildfiles don't have any" << ::std::endl
+       << "                     side effects outside of their directories." << ::std::endl;
+
     os << std::endl
        << "\033[1m--no-column\033[0m          Don't print column numbers in diagnostics." << ::std::endl;
 
@@ -909,6 +940,11 @@ namespace build2
         &options::verbose_specified_ >;
       _cli_options_map_["--stat"] = 
       &::build2::cl::thunk< options, bool, &options::stat_ >;
+      _cli_options_map_["--mem-stat"] = 
+      &::build2::cl::thunk< options, bool, &options::mem_stat_ >;
+      _cli_options_map_["--trace-file"] = 
+      &::build2::cl::thunk< options, path, &options::trace_file_,
+        &options::trace_file_specified_ >;
       _cli_options_map_["--dump"] = 
       &::build2::cl::thunk< options, std::set<string>, &options::dump_,
         &options::dump_specified_ >;
@@ -945,6 +981,8 @@ namespace build2
       &::build2::cl::thunk< options, bool, &options::structured_result_ >;
       _cli_options_map_["--match-only"] = 
       &::build2::cl::thunk< options, bool, &options::match_only_ >;
+      _cli_options_map_["--load-on-demand"] = 
+      &::build2::cl::thunk< options, bool, &options::load_on_demand_ >;
       _cli_options_map_["--no-column"] = 
       &::build2::cl::thunk< options, bool, &options::no_column_ >;
       _cli_options_map_["--no-line"] = 
@@ -439,6 +439,15 @@ namespace build2
     const bool&
     stat () const;
 
+    const bool&
+    mem_stat () const;
+
+    const path&
+    trace_file () const;
+
+    bool
+    trace_file_specified () const;
+
     const std::set<string>&
     dump () const;
 
@@ -484,6 +493,9 @@ namespace build2
     const bool&
     match_only () const;
 
+    const bool&
+    load_on_demand () const;
+
     const bool&
     no_column () const;
 
@@ -553,6 +565,9 @@ namespace build2
     uint16_t verbose_;
     bool verbose_specified_;
     bool stat_;
+    bool mem_stat_;
+    path trace_file_;
+    bool trace_file_specified_;
     std::set<string> dump_;
     bool dump_specified_;
     size_t jobs_;
@@ -568,6 +583,7 @@ namespace build2
     bool no_mtime_check_;
     bool structured_result_;
     bool match_only_;
+    bool load_on_demand_;
     bool no_column_;
     bool no_line_;
     path buildfile_;
@@ -279,6 +279,24 @@ namespace build2
     return this->stat_;
   }
 
+  inline const bool& options::
+  mem_stat () const
+  {
+    return this->mem_stat_;
+  }
+
+  inline const path& options::
+  trace_file () const
+  {
+    return this->trace_file_;
+  }
+
+  inline bool options::
+  trace_file_specified () const
+  {
+    return this->trace_file_specified_;
+  }
+
   inline const std::set<string>& options::
   dump () const
   {
@@ -369,6 +387,12 @@ namespace build2
     return this->match_only_;
   }
 
+  inline const bool& options::
+  load_on_demand () const
+  {
+    return this->load_on_demand_;
+  }
+
   inline const bool& options::
   no_column () const
   {
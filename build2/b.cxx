@@ -12,7 +12,9 @@
 #  include <locale>
 #endif
 
+#include <new>         // bad_alloc, get_new_handler()
 #include <sstream>
+#include <cstdlib>     // malloc(), free()
 #include <cstring>     // strcmp(), strchr()
 #include <typeinfo>
 #include <iostream>    // cout
@@ -29,8 +31,10 @@
 #include <build2/spec.hxx>
 #include <build2/scope.hxx>
 #include <build2/module.hxx>
+#include <build2/memory.hxx>
 #include <build2/target.hxx>
 #include <build2/context.hxx>
+#include <build2/timeline.hxx>
 #include <build2/variable.hxx>
 #include <build2/algorithm.hxx>
 #include <build2/operation.hxx>
@@ -68,6 +72,13 @@ namespace build2
   int
   main (int argc, char* argv[]);
 
+  // Number and total size of heap allocations (see --stat and --mem-stat).
+  // Only counted once requested (see operator new below).
+  //
+  static bool count_allocations (false);
+  static std::atomic<uint64_t> allocation_count (0);
+  static std::atomic<uint64_t> allocation_bytes (0);
+
   // Structured result printer (--structured-result mode).
   //
   class result_printer
@@ -335,6 +346,11 @@ main (int argc, char* argv[])
     // Global initializations.
     //
     stderr_term = fdterm (stderr_fd ());
+    count_allocations = ops.stat () || ops.mem_stat ();
+
+    if (ops.mem_stat ())
+      memory_enable ();
+
     init (argv[0],
           ops.verbose_specified ()
           ? ops.verbose ()
@@ -433,6 +449,7 @@ main (int argc, char* argv[])
     }
 
     keep_going = !ops.serial_stop ();
+    load_on_demand = ops.load_on_demand ();
 
     // Start up the scheduler and allocate lock shards.
     //
@@ -465,6 +482,11 @@ main (int argc, char* argv[])
         fail << "invalid --max-jobs|-J value";
     }
 
+    // Enable the timeline before starting any threads.
+    //
+    if (ops.trace_file_specified ())
+      timeline_enable ();
+
     sched.startup (jobs,
                    1,
                    max_jobs,
@@ -1344,8 +1366,11 @@ main (int argc, char* argv[])
 
           l5 ([&]{trace << "loading " << tn;});
 
-          // Load the buildfile.
+          // Load the buildfile. Note that this happens outside of any phase
+          // lock so make sure the lookup caches populated by the previous
+          // match are invalidated.
           //
+          lookup_generation++;
           mif->load (mparams, rs, ts.buildfile, ts.out_base, ts.src_base, l);
 
           // Next search and match the targets. We don't want to start
@@ -1398,21 +1423,15 @@ main (int argc, char* argv[])
 
         // Finally, match the rules and perform the operation.
         //
-        if (pre_oid != 0)
+        // Note that we call the operation end callbacks even if the
+        // operation has failed (so that, for example, the test history
+        // records the failed tests).
+        //
+        auto perform = [&] (action a, uint16_t diag)
         {
-          l5 ([&]{trace << "start pre-operation batch " << pre_oif->name
-                        << ", id " << static_cast<uint16_t> (pre_oid);});
-
-          if (mif->operation_pre != nullptr)
-            mif->operation_pre (mparams, pre_oid); // Cannot be translated.
-
-          set_current_oif (*pre_oif, oif);
-
-          action a (mid, pre_oid, oid);
-
+          try
           {
             result_printer p (tgs);
-            uint16_t diag (ops.structured_result () ? 0 : 1);
 
             if (mif->match != nullptr)
               mif->match (mparams, a, tgs, diag, true /* progress */);
@@ -1423,6 +1442,31 @@ main (int argc, char* argv[])
             if (mif->execute != nullptr && !ops.match_only ())
               mif->execute (mparams, a, tgs, diag, true /* progress */);
           }
+          catch (const failed&)
+          {
+            for (const auto& f: operation_end_callbacks)
+              f (a);
+
+            throw;
+          }
+
+          for (const auto& f: operation_end_callbacks)
+            f (a);
+        };
+
+        if (pre_oid != 0)
+        {
+          l5 ([&]{trace << "start pre-operation batch " << pre_oif->name
+                        << ", id " << static_cast<uint16_t> (pre_oid);});
+
+          if (mif->operation_pre != nullptr)
+            mif->operation_pre (mparams, pre_oid); // Cannot be translated.
+
+          set_current_oif (*pre_oif, oif);
+
+          action a (mid, pre_oid, oid);
+
+          perform (a, ops.structured_result () ? 0 : 1);
 
           if (mif->operation_post != nullptr)
             mif->operation_post (mparams, pre_oid);
@@ -1437,19 +1481,7 @@ main (int argc, char* argv[])
 
         action a (mid, oid, oif->outer_id);
 
-        {
-          result_printer p (tgs);
-          uint16_t diag (ops.structured_result () ? 0 : 2);
-
-          if (mif->match != nullptr)
-            mif->match (mparams, a, tgs, diag, true /* progress */);
-
-          if (dump_match)
-            dump (a);
-
-          if (mif->execute != nullptr && !ops.match_only ())
-            mif->execute (mparams, a, tgs, diag, true /* progress */);
-        }
+        perform (a, ops.structured_result () ? 0 : 2);
 
         if (post_oid != 0)
         {
@@ -1465,19 +1497,7 @@ main (int argc, char* argv[])
 
           action a (mid, post_oid, oid);
 
-          {
-            result_printer p (tgs);
-            uint16_t diag (ops.structured_result () ? 0 : 1);
-
-            if (mif->match != nullptr)
-              mif->match (mparams, a, tgs, diag, true /* progress */);
-
-            if (dump_match)
-              dump (a);
-
-            if (mif->execute != nullptr && !ops.match_only ())
-              mif->execute (mparams, a, tgs, diag, true /* progress */);
-          }
+          perform (a, ops.structured_result () ? 0 : 1);
 
           if (mif->operation_post != nullptr)
             mif->operation_post (mparams, post_oid);
@@ -1522,6 +1542,46 @@ main (int argc, char* argv[])
   //
   assert (st.task_queue_remain == 0);
 
+  // Now that all the threads are quiescent write the timeline.
+  //
+  if (ops.trace_file_specified ())
+  {
+    const path& f (ops.trace_file ());
+
+    try
+    {
+      timeline_write (f);
+    }
+    catch (const io_error& e)
+    {
+      error << "unable to write trace file " << f << ": " << e;
+      r = 1;
+    }
+  }
+
+  // Print the memory usage in the machine-readable form (see --mem-stat).
+  //
+  if (ops.mem_stat ())
+  {
+    for (size_t i (0);
+         i != static_cast<size_t> (memory_subsystem::count_);
+         ++i)
+    {
+      const memory_counter& c (memory_counters[i]);
+
+      cout << "mem " << to_string (static_cast<memory_subsystem> (i))
+           << ' ' << c.live.load (memory_order_relaxed)
+           << ' ' << c.peak.load (memory_order_relaxed)
+           << ' ' << c.allocations.load (memory_order_relaxed)
+           << ' ' << c.bytes.load (memory_order_relaxed) << '\n';
+    }
+
+    // The totals are only known for the allocations.
+    //
+    cout << "mem total 0 0 " << allocation_count.load () << ' '
+         << allocation_bytes.load () << endl;
+  }
+
   if (ops.stat ())
   {
     text << '\n'
@@ -1536,11 +1596,83 @@ main (int argc, char* argv[])
          << '\n'
          << "  wait_queue_slots       " << st.wait_queue_slots      << '\n'
          << "  wait_queue_collisions  " << st.wait_queue_collisions << '\n';
+
+    phase_switch_stat ps (phase_switch_statistics ());
+
+    auto ms = [] (duration d)
+    {
+      return chrono::duration_cast<chrono::milliseconds> (d).count ();
+    };
+
+    text << '\n'
+         << "  load_switches          " << ps.load_switches          << '\n'
+         << "  load_stall_ms          " << ms (ps.load_stall)        << '\n'
+         << "  execute_switches       " << ps.execute_switches       << '\n'
+         << "  execute_targets        " << ps.execute_targets        << '\n'
+         << "  execute_stall_ms       " << ms (ps.execute_stall)     << '\n'
+         << '\n'
+         << "  heap_allocations       " << allocation_count.load ()  << '\n';
+
+    if (!ps.longest.empty ())
+    {
+      diag_record dr (text);
+      dr << '\n' << "  longest phase switch stalls (ms):" << '\n';
+
+      for (const pair<duration, string>& p: ps.longest)
+        dr << '\n' << "    " << ms (p.first) << '\t' << p.second;
+    }
+
+    vector<target_wait_stat> ws (target_wait_statistics ());
+
+    if (!ws.empty ())
+    {
+      diag_record dr (text);
+      dr << '\n' << "  target waits (suspends, collisions, collision rate %):"
+         << '\n';
+
+      for (const target_wait_stat& s: ws)
+        dr << '\n' << "    " << s.type->name << '\t' << s.suspends << '\t'
+           << s.collisions << '\t' << s.collisions * 100 / s.suspends;
+    }
   }
 
   return r;
 }
 
+// Replace the global allocation function to count the allocations (see
+// --stat and --mem-stat). Note that the rest of the allocation/deallocation
+// functions end up calling these two.
+//
+void*
+operator new (size_t n)
+{
+  if (build2::count_allocations)
+  {
+    build2::allocation_count.fetch_add (1, std::memory_order_relaxed);
+    build2::allocation_bytes.fetch_add (n, std::memory_order_relaxed);
+
+    if (build2::memory_enabled ())
+      build2::memory_attribute (n);
+  }
+
+  for (;;)
+  {
+    if (void* p = malloc (n != 0 ? n : 1))
+      return p;
+
+    if (std::new_handler h = std::get_new_handler ())
+      h ();
+    else
+      throw std::bad_alloc ();
+  }
+}
+
+void
+operator delete (void* p) noexcept
+{
+  free (p);
+}
+
 int
 main (int argc, char* argv[])
 {
@@ -4,6 +4,8 @@
 
 #include <build2/bin/guess.hxx>
 
+#include <map>
+
 #include <build2/diagnostics.hxx>
 
 using namespace std;
@@ -37,11 +39,41 @@ namespace build2
       return v ? *v : semantic_version ();
     }
 
-    ar_info
+    // Return the cache key for the specified tool paths and fallback
+    // directory.
+    //
+    static string
+    cache_key (const path& p, const path* rl, const dir_path& fallback)
+    {
+      string r (p.string ());
+      r += '\n';
+      if (rl != nullptr) r += rl->string ();
+      r += '\n';
+      r += fallback.string ();
+      return r;
+    }
+
+    // Running the tools can be expensive (and with many subprojects we may
+    // end up guessing the same tool many times) so we cache the results.
+    // Note that module initialization happens during the serial load phase
+    // so no locking is necessary.
+    //
+    static std::map<string, ar_info> ar_cache;
+    static std::map<string, ld_info> ld_cache;
+    static std::map<string, rc_info> rc_cache;
+
+    const ar_info&
     guess_ar (const path& ar, const path* rl, const dir_path& fallback)
     {
       tracer trace ("bin::guess_ar");
 
+      string key (cache_key (ar, rl, fallback));
+      {
+        auto i (ar_cache.find (key));
+        if (i != ar_cache.end ())
+          return i->second;
+      }
+
       process_path arp, rlp;
       guess_result arr, rlr;
 
@@ -244,7 +276,7 @@ namespace build2
           fail << "unable to guess " << *rl << " signature";
       }
 
-      return ar_info {
+      return (ar_cache[key] = ar_info {
         move (arp),
         move (arr.id),
         move (arr.signature),
@@ -254,14 +286,21 @@ namespace build2
         move (rlp),
         move (rlr.id),
         move (rlr.signature),
-        move (rlr.checksum)};
+        move (rlr.checksum)});
     }
 
-    ld_info
+    const ld_info&
     guess_ld (const path& ld, const dir_path& fallback)
     {
       tracer trace ("bin::guess_ld");
 
+      string key (cache_key (ld, nullptr, fallback));
+      {
+        auto i (ld_cache.find (key));
+        if (i != ld_cache.end ())
+          return i->second;
+      }
+
       guess_result r;
 
       process_path pp;
@@ -384,15 +423,22 @@ namespace build2
       if (r.empty ())
         fail << "unable to guess " << ld << " signature";
 
-      return ld_info {
-        move (pp), move (r.id), move (r.signature), move (r.checksum)};
+      return (ld_cache[key] = ld_info {
+        move (pp), move (r.id), move (r.signature), move (r.checksum)});
     }
 
-    rc_info
+    const rc_info&
     guess_rc (const path& rc, const dir_path& fallback)
     {
       tracer trace ("bin::guess_rc");
 
+      string key (cache_key (rc, nullptr, fallback));
+      {
+        auto i (rc_cache.find (key));
+        if (i != rc_cache.end ())
+          return i->second;
+      }
+
       guess_result r;
 
       process_path pp;
@@ -457,8 +503,8 @@ namespace build2
       if (r.empty ())
         fail << "unable to guess " << rc << " signature";
 
-      return rc_info {
-        move (pp), move (r.id), move (r.signature), move (r.checksum)};
+      return (rc_cache[key] = rc_info {
+        move (pp), move (r.id), move (r.signature), move (r.checksum)});
     }
   }
 }
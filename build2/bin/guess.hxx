@@ -45,7 +45,9 @@ namespace build2
     // The ranlib path can be NULL, in which case no ranlib guessing will be
     // attemplated and the returned ranlib_* members will be left empty.
     //
-    ar_info
+    // Note that the results of this and the below functions are cached.
+    //
+    const ar_info&
     guess_ar (const path& ar, const path* ranlib, const dir_path& fallback);
 
     // ld information.
@@ -76,7 +78,7 @@ namespace build2
       string checksum;
     };
 
-    ld_info
+    const ld_info&
     guess_ld (const path& ld, const dir_path& fallback);
 
     // rc information.
@@ -100,7 +102,7 @@ namespace build2
       string checksum;
     };
 
-    rc_info
+    const rc_info&
     guess_rc (const path& rc, const dir_path& fallback);
   }
 }
@@ -66,6 +66,8 @@ namespace build2
       vp.insert<strings>   ("config.bin.liba.lib", true);
       vp.insert<strings>   ("config.bin.libs.lib", true);
       vp.insert<dir_paths> ("config.bin.rpath",    true);
+      vp.insert<bool>      ("config.bin.liba.thin", true);
+      vp.insert<path>      ("config.bin.dwp",      true);
 
       vp.insert<string>    ("config.bin.prefix", true);
       vp.insert<string>    ("config.bin.suffix", true);
@@ -80,6 +82,16 @@ namespace build2
       vp.insert<strings>   ("bin.libs.lib");
       vp.insert<dir_paths> ("bin.rpath");
 
+      // Produce thin archives for liba{} (utility libraries are always thin,
+      // if supported). Note that this is ignored when updating for install.
+      //
+      vp.insert<bool>      ("bin.liba.thin");
+
+      // Package split DWARF (.dwo) files of executables and shared libraries
+      // into .dwp with this program (for example, dwp or llvm-dwp).
+      //
+      vp.insert<process_path> ("bin.dwp.path");
+
       // Link whole archive. Note: non-overridable with target visibility.
       //
       // The lookup semantics is as follows: we first look for a prerequisite-
@@ -191,6 +203,22 @@ namespace build2
       rs.assign ("bin.rpath") += cast_null<dir_paths> (
         optional (rs, "config.bin.rpath"));
 
+      // config.bin.liba.thin
+      //
+      // Also not used very often so omitted from config.build if not
+      // specified.
+      //
+      if (lookup l = omitted (rs, "config.bin.liba.thin").first)
+        rs.assign ("bin.liba.thin") = *l;
+
+      // config.bin.dwp
+      //
+      // Omitted if not specified (in which case no packaging is performed).
+      //
+      if (lookup l = omitted (rs, "config.bin.dwp").first)
+        rs.assign<process_path> ("bin.dwp.path") =
+          run_search (cast<path> (l), true /* init */);
+
       // config.bin.{lib,exe}.{prefix,suffix}
       //
       // These ones are not used very often so we will omit them from the
@@ -583,7 +611,7 @@ namespace build2
         const path& ar (cast<path> (ap.first));
         const path* ranlib (cast_null<path> (rp.first));
 
-        ar_info ari (
+        const ar_info& ari (
           guess_ar (ar, ranlib, fb ? dir_path (*pat) : dir_path ()));
 
         // If this is a new value (e.g., we are configuring), then print the
@@ -623,29 +651,31 @@ namespace build2
           }
         }
 
-        rs.assign<process_path> ("bin.ar.path")      = move (ari.ar_path);
-        rs.assign<string>       ("bin.ar.id")        = move (ari.ar_id);
-        rs.assign<string>       ("bin.ar.signature") = move (ari.ar_signature);
-        rs.assign<string>       ("bin.ar.checksum")  = move (ari.ar_checksum);
+        rs.assign<process_path> ("bin.ar.path") =
+          process_path (ari.ar_path, false /* init */);
+        rs.assign<string>       ("bin.ar.id")        = ari.ar_id;
+        rs.assign<string>       ("bin.ar.signature") = ari.ar_signature;
+        rs.assign<string>       ("bin.ar.checksum")  = ari.ar_checksum;
 
         {
-          semantic_version& v (ari.ar_version);
+          const semantic_version& v (ari.ar_version);
 
           rs.assign<string>   ("bin.ar.version")       = v.string ();
           rs.assign<uint64_t> ("bin.ar.version.major") = v.major;
           rs.assign<uint64_t> ("bin.ar.version.minor") = v.minor;
           rs.assign<uint64_t> ("bin.ar.version.patch") = v.patch;
-          rs.assign<string>   ("bin.ar.version.build") = move (v.build);
+          rs.assign<string>   ("bin.ar.version.build") = v.build;
         }
 
         if (ranlib != nullptr)
         {
-          rs.assign<process_path> ("bin.ranlib.path") = move (ari.ranlib_path);
-          rs.assign<string>       ("bin.ranlib.id")   = move (ari.ranlib_id);
+          rs.assign<process_path> ("bin.ranlib.path") =
+            process_path (ari.ranlib_path, false /* init */);
+          rs.assign<string>       ("bin.ranlib.id")        = ari.ranlib_id;
           rs.assign<string>       ("bin.ranlib.signature") =
-            move (ari.ranlib_signature);
-          rs.assign<string>       ("bin.ranlib.checksum") =
-            move (ari.ranlib_checksum);
+            ari.ranlib_signature;
+          rs.assign<string>       ("bin.ranlib.checksum")  =
+            ari.ranlib_checksum;
         }
       }
 
@@ -727,7 +757,8 @@ namespace build2
             config::save_commented));
 
         const path& ld (cast<path> (p.first));
-        ld_info ldi (guess_ld (ld, fb ? dir_path (*pat) : dir_path ()));
+        const ld_info& ldi (
+          guess_ld (ld, fb ? dir_path (*pat) : dir_path ()));
 
         // If this is a new value (e.g., we are configuring), then print the
         // report at verbosity level 2 and up (-v).
@@ -741,10 +772,11 @@ namespace build2
                << "  checksum   " << ldi.checksum;
         }
 
-        rs.assign<process_path> ("bin.ld.path")      = move (ldi.path);
-        rs.assign<string>       ("bin.ld.id")        = move (ldi.id);
-        rs.assign<string>       ("bin.ld.signature") = move (ldi.signature);
-        rs.assign<string>       ("bin.ld.checksum")  = move (ldi.checksum);
+        rs.assign<process_path> ("bin.ld.path") =
+          process_path (ldi.path, false /* init */);
+        rs.assign<string>       ("bin.ld.id")        = ldi.id;
+        rs.assign<string>       ("bin.ld.signature") = ldi.signature;
+        rs.assign<string>       ("bin.ld.checksum")  = ldi.checksum;
       }
 
       return true;
@@ -838,7 +870,8 @@ namespace build2
             config::save_commented));
 
         const path& rc (cast<path> (p.first));
-        rc_info rci (guess_rc (rc, fb ? dir_path (*pat) : dir_path ()));
+        const rc_info& rci (
+          guess_rc (rc, fb ? dir_path (*pat) : dir_path ()));
 
         // If this is a new value (e.g., we are configuring), then print the
         // report at verbosity level 2 and up (-v).
@@ -852,10 +885,11 @@ namespace build2
                << "  checksum   " << rci.checksum;
         }
 
-        rs.assign<process_path> ("bin.rc.path")      = move (rci.path);
-        rs.assign<string>       ("bin.rc.id")        = move (rci.id);
-        rs.assign<string>       ("bin.rc.signature") = move (rci.signature);
-        rs.assign<string>       ("bin.rc.checksum")  = move (rci.checksum);
+        rs.assign<process_path> ("bin.rc.path") =
+          process_path (rci.path, false /* init */);
+        rs.assign<string>       ("bin.rc.id")        = rci.id;
+        rs.assign<string>       ("bin.rc.signature") = rci.signature;
+        rs.assign<string>       ("bin.rc.checksum")  = rci.checksum;
       }
 
       return true;
@@ -202,6 +202,7 @@ namespace build2
         v["cc.system"],
         v["cc.module_name"],
         v["cc.reprocess"],
+        v["cc.compiledb"],
 
         v.insert<string>   ("c.preprocessed"), // See cxx.preprocessed.
         nullptr,                               // No __symexport (no modules).
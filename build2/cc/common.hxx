@@ -81,6 +81,7 @@ namespace build2
       const variable& c_system;       // cc.system
       const variable& c_module_name;  // cc.module_name
       const variable& c_reprocess;    // cc.reprocess
+      const variable& c_compiledb;    // cc.compiledb
 
       const variable& x_preprocessed; // x.preprocessed
       const variable* x_symexport;    // x.features.symexport
@@ -19,9 +19,10 @@
 #include <build2/config/utility.hxx> // create_project()
 
 #include <build2/cc/parser.hxx>
-#include <build2/cc/target.hxx>  // h
+#include <build2/cc/target.hxx>  // h, dwo
 #include <build2/cc/module.hxx>
 #include <build2/cc/utility.hxx>
+#include <build2/cc/compiledb.hxx>
 
 using std::exit;
 using std::strlen;
@@ -477,7 +478,7 @@ namespace build2
         // @@ MT perf: so we are going to switch the phase and execute for
         //    any generated header.
         //
-        phase_switch ps (run_phase::execute);
+        phase_switch ps (run_phase::execute, &t);
         target_state ns (execute_direct (a, t));
 
         if (ns != os && ns != target_state::unchanged)
@@ -492,6 +493,69 @@ namespace build2
       }
     }
 
+    // As above but for several targets and return true if any of them has
+    // changed or is newer. The targets that need executing are all updated
+    // in a single phase switch rather than switching for each of them (each
+    // switch requires all the other threads to leave the match phase).
+    //
+    static bool
+    update (tracer& trace, action a,
+            const small_vector<const target*, 16>& ts, timestamp mt)
+    {
+      bool r (false);
+
+      small_vector<pair<const target*, target_state>, 16> es;
+
+      for (const target* t: ts)
+      {
+        target_state os (t->matched_state (a));
+
+        if (os == target_state::unchanged)
+        {
+          if (!r && mt != timestamp_unknown)
+          {
+            if (const path_target* pt = t->is_a<path_target> ())
+            {
+              // We expect the timestamp to be known (i.e., existing file).
+              //
+              timestamp m (pt->mtime ());
+              assert (m != timestamp_unknown);
+              r = m > mt;
+            }
+          }
+        }
+        else
+          es.push_back (make_pair (t, os));
+      }
+
+      if (!es.empty ())
+      {
+        phase_switch ps (run_phase::execute, es.front ().first, es.size ());
+
+        for (const auto& e: es)
+        {
+          const target& t (*e.first);
+          target_state os (e.second);
+          target_state ns (execute_direct (a, t));
+
+          if (ns != os && ns != target_state::unchanged)
+          {
+            l6 ([&]{trace << "updated " << t
+                          << "; old state " << os
+                          << "; new state " << ns;});
+            r = true;
+          }
+          else if (!r && mt != timestamp_unknown)
+          {
+            if (const path_target* pt = t.is_a<path_target> ())
+              r = pt->newer (mt);
+          }
+        }
+      }
+
+      return r;
+    }
+
     recipe compile_rule::
     apply (action a, target& xt) const
     {
@@ -594,6 +658,30 @@ namespace build2
 
       const path& tp (t.derive_path (e.c_str ()));
 
+      // Add the split DWARF .dwo file as an ad hoc member. Both GCC and Clang
+      // write it next to the object file replacing its extension.
+      //
+      // Note that being a member of obj*{} (or of bmi*{} after obj*{}) it is
+      // cleaned automatically and, like object files, is not installed (the
+      // link rule can package it into .dwp which is).
+      //
+      if ((ctype == compiler_type::gcc || ctype == compiler_type::clang) &&
+          tsys != "win32-msvc"                                           &&
+          (find_option ("-gsplit-dwarf", t, c_coptions) ||
+           find_option ("-gsplit-dwarf", t, x_coptions)))
+      {
+        const path& op (mod ? t.member->as<file> ().path () : tp);
+
+        target_lock dw (
+          add_adhoc_member (a, t,
+                            dwo::static_type,
+                            t.dir, t.out,
+                            op.leaf ().base ().string ()));
+
+        dw.target->as<file> ().derive_path ();
+        match_recipe (dw, group_recipe); // Set recipe and unlock.
+      }
+
       // Inject dependency on the output directory.
       //
       const fsdir* dir (inject_fsdir (a, t));
@@ -838,12 +926,18 @@ namespace build2
         // hoc/out-of-band compiler input file that is passed via the command
         // line. So, to be safe, we make sure everything is up to date.
         //
-        for (const target* pt: pts)
         {
-          if (pt == nullptr || pt == dir)
-            continue;
+          small_vector<const target*, 16> ts;
 
-          u = update (trace, a, *pt, u ? timestamp_unknown : mt) || u;
+          for (const target* pt: pts)
+          {
+            if (pt == nullptr || pt == dir)
+              continue;
+
+            ts.push_back (pt);
+          }
+
+          u = update (trace, a, ts, u ? timestamp_unknown : mt) || u;
         }
 
         // Check if the source is already preprocessed to a certain degree.
@@ -1037,6 +1131,19 @@ namespace build2
         // second in depdb (which is never newer that the target).
         //
         md.mt = u ? timestamp_nonexistent : dd.mtime;
+
+        // Record the command line in the compilation database, if requested.
+        // Note that we do it even if the target is up-to-date in order to
+        // keep the database complete.
+        //
+        if (const path* db = cast_null<path> (rs[c_compiledb]))
+        {
+          command_line cl;
+          append_args (cl, a, t, src, md);
+
+          compiledb::instance (*db).insert (
+            src.path (), mod ? t.member->is_a<file> ()->path () : tp, cl.args);
+        }
       }
 
       switch (a)
@@ -4214,54 +4321,16 @@ namespace build2
         env.push_back ("IFCPATH");
     }
 
-    target_state compile_rule::
-    perform_update (action a, const target& xt) const
+    void compile_rule::
+    append_args (command_line& cl,
+                 action a,
+                 const file& t,
+                 const file& s,
+                 const match_data& md) const
     {
-      const file& t (xt.as<file> ());
       const path& tp (t.path ());
-
-      match_data md (move (t.data<match_data> ()));
-      bool mod (md.type == translation_type::module_iface);
-
-      // While all our prerequisites are already up-to-date, we still have to
-      // execute them to keep the dependency counts straight. Actually, no, we
-      // may also have to update the modules.
-      //
-      auto pr (
-        execute_prerequisites<file> (
-          (mod ? *x_mod : x_src),
-          a, t,
-          md.mt,
-          [s = md.mods.start] (const target&, size_t i)
-          {
-            return s != 0 && i >= s; // Only compare timestamps for modules.
-          },
-          md.mods.copied)); // See search_modules() for details.
-
-      const file& s (pr.second);
       const path* sp (&s.path ());
-
-      if (pr.first)
-      {
-        if (md.touch)
-        {
-          touch (tp, false, 2);
-          skip_count.fetch_add (1, memory_order_relaxed);
-        }
-
-        t.mtime (md.mt);
-        return *pr.first;
-      }
-
-      // Make sure depdb is no older than any of our prerequisites (see md.mt
-      // logic description above for details). Also save the sequence start
-      // time if doing mtime checks (see the depdb::check_mtime() call below).
-      //
-      timestamp start (depdb::mtime_check ()
-                       ? system_clock::now ()
-                       : timestamp_unknown);
-
-      touch (md.dd, false, verb_never);
+      bool mod (md.type == translation_type::module_iface);
 
       const scope& bs (t.base_scope ());
       const scope& rs (*bs.root_scope ());
@@ -4269,14 +4338,17 @@ namespace build2
       otype ot (compile_type (t, mod));
       linfo li (link_info (bs, ot));
 
-      environment env;
-      cstrings args {cpath.recall_string ()};
+      environment& env (cl.env);
+      cstrings& args (cl.args);
+
+      args.push_back (cpath.recall_string ());
 
       // If we are building a module, then the target is bmi*{} and its ad hoc
       // member is obj*{}.
       //
-      path relm;
-      path relo (relative (mod ? t.member->is_a<file> ()->path () : tp));
+      path& relm (cl.relm);
+      path& relo (cl.relo);
+      relo = relative (mod ? t.member->is_a<file> ()->path () : tp);
 
       // Build the command line.
       //
@@ -4305,9 +4377,10 @@ namespace build2
       append_options (args, t, x_coptions);
       append_options (args, tstd);
 
-      string out, out1; // Output options storage.
-      strings mods;     // Module options storage.
-      size_t out_i (0); // Index of the -o option.
+      string& out (cl.out);
+      string& out1 (cl.out1);
+      strings& mods (cl.mods);
+      size_t& out_i (cl.out_i);
 
       if (cclass == compiler_class::msvc)
       {
@@ -4507,6 +4580,65 @@ namespace build2
 
         args.push_back (sp->string ().c_str ());
       }
+    }
+
+    target_state compile_rule::
+    perform_update (action a, const target& xt) const
+    {
+      const file& t (xt.as<file> ());
+      const path& tp (t.path ());
+
+      match_data md (move (t.data<match_data> ()));
+      bool mod (md.type == translation_type::module_iface);
+
+      // While all our prerequisites are already up-to-date, we still have to
+      // execute them to keep the dependency counts straight. Actually, no, we
+      // may also have to update the modules.
+      //
+      auto pr (
+        execute_prerequisites<file> (
+          (mod ? *x_mod : x_src),
+          a, t,
+          md.mt,
+          [s = md.mods.start] (const target&, size_t i)
+          {
+            return s != 0 && i >= s; // Only compare timestamps for modules.
+          },
+          md.mods.copied)); // See search_modules() for details.
+
+      const file& s (pr.second);
+      const path* sp (&s.path ());
+
+      if (pr.first)
+      {
+        if (md.touch)
+        {
+          touch (tp, false, 2);
+          skip_count.fetch_add (1, memory_order_relaxed);
+        }
+
+        t.mtime (md.mt);
+        return *pr.first;
+      }
+
+      // Make sure depdb is no older than any of our prerequisites (see md.mt
+      // logic description above for details). Also save the sequence start
+      // time if doing mtime checks (see the depdb::check_mtime() call below).
+      //
+      timestamp start (depdb::mtime_check ()
+                       ? system_clock::now ()
+                       : timestamp_unknown);
+
+      touch (md.dd, false, verb_never);
+
+      command_line cl;
+      append_args (cl, a, t, s, md);
+
+      environment& env (cl.env);
+      cstrings& args (cl.args);
+      const path& relm (cl.relm);
+      const path& relo (cl.relo);
+      size_t out_i (cl.out_i);
 
       args.push_back (nullptr);
 
@@ -4694,6 +4826,17 @@ namespace build2
     {
       const file& t (xt.as<file> ());
 
+      // Remove the entry from the compilation database, if any.
+      //
+      if (const path* db = cast_null<path> (t.root_scope ()[c_compiledb]))
+      {
+        // If this is a module, then the target is bmi*{} and its ad hoc
+        // member is obj*{}.
+        //
+        const file& o (t.is_a<bmix> () ? t.member->as<file> () : t);
+        compiledb::instance (*db).erase (o.path ());
+      }
+
       using ct = compiler_type;
 
       switch (ctype)
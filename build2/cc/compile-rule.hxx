@@ -58,6 +58,29 @@ namespace build2
       struct match_data;
       using environment = small_vector<const char*, 2>;
 
+      // Compiler command line and the storage for its arguments.
+      //
+      struct command_line
+      {
+        environment env;
+        cstrings args;
+
+        path relo;        // Object file (relative).
+        path relm;        // Module file (relative), if any.
+        string out, out1; // Output options storage.
+        strings mods;     // Module options storage.
+        size_t out_i = 0; // Index of the -o option.
+      };
+
+      // Build the command line (without the terminating NULL) for compiling
+      // the specified source file. Used both to actually compile and to
+      // record the compilation database entry.
+      //
+      void
+      append_args (command_line&,
+                   action, const file&, const file&,
+                   const match_data&) const;
+
       void
       append_lib_options (const scope&,
                           cstrings&,
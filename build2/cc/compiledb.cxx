@@ -0,0 +1,263 @@
+// file      : build2/cc/compiledb.cxx -*- C++ -*-
+// copyright : Copyright (c) 2014-2019 Code Synthesis Ltd
+// license   : MIT; see accompanying LICENSE file
+
+#include <build2/cc/compiledb.hxx>
+
+#include <cstring> // strlen()
+
+#include <build2/context.hxx>
+#include <build2/filesystem.hxx>
+#include <build2/diagnostics.hxx>
+
+using namespace std;
+using namespace butl;
+
+namespace build2
+{
+  namespace cc
+  {
+    // All the databases in this build keyed by their paths. Note that they
+    // are not affected by reset() since they are not part of the build
+    // state.
+    //
+    static map<path, unique_ptr<compiledb>> databases;
+    static mutex databases_mutex;
+
+    compiledb& compiledb::
+    instance (const path& p)
+    {
+      mlock l (databases_mutex);
+
+      auto i (databases.find (p));
+      if (i != databases.end ())
+        return *i->second;
+
+      // Register the write callback with the first database.
+      //
+      if (databases.empty ())
+        operation_end_callbacks.push_back (&write_all);
+
+      return *databases.emplace (
+        p, unique_ptr<compiledb> (new compiledb (p))).first->second;
+    }
+
+    static void
+    to_json (string& r, const char* s)
+    {
+      r += '"';
+
+      for (; *s != '\0'; ++s)
+      {
+        char c (*s);
+
+        switch (c)
+        {
+        case '"':  r += "\\\""; break;
+        case '\\': r += "\\\\"; break;
+        case '\n': r += "\\n";  break;
+        case '\r': r += "\\r";  break;
+        case '\t': r += "\\t";  break;
+        default:
+          {
+            if (static_cast<unsigned char> (c) < 0x20)
+            {
+              const char* h ("0123456789abcdef");
+
+              r += "\\u00";
+              r += h[(c >> 4) & 0x0f];
+              r += h[c & 0x0f];
+            }
+            else
+              r += c;
+          }
+        }
+      }
+
+      r += '"';
+    }
+
+    // Extract the output file path from an entry line written by insert().
+    // Return empty string if the line is not recognized.
+    //
+    static string
+    entry_output (const string& l)
+    {
+      const char* k ("\"output\": \"");
+
+      size_t p (l.find (k));
+      if (p == string::npos)
+        return string ();
+
+      string r;
+      for (p += strlen (k); p != l.size (); ++p)
+      {
+        char c (l[p]);
+
+        if (c == '"')
+          return r;
+
+        if (c == '\\')
+        {
+          if (++p == l.size ())
+            break;
+
+          switch (c = l[p])
+          {
+          case 'n': c = '\n'; break;
+          case 'r': c = '\r'; break;
+          case 't': c = '\t'; break;
+          case 'u': return string (); // Not something we would write here.
+          }
+        }
+
+        r += c;
+      }
+
+      return string (); // Unterminated.
+    }
+
+    void compiledb::
+    insert (const path& file, const path& output, const cstrings& args)
+    {
+      // Format the entry before grabbing the lock in order not to serialize
+      // parallel matches on it.
+      //
+      string e ("{\"directory\": ");
+      to_json (e, relative_base->string ().c_str ());
+
+      e += ", \"file\": ";
+      to_json (e, file.string ().c_str ());
+
+      e += ", \"output\": ";
+      to_json (e, output.string ().c_str ());
+
+      e += ", \"arguments\": [";
+      for (size_t i (0); i != args.size (); ++i)
+      {
+        if (i != 0)
+          e += ", ";
+
+        to_json (e, args[i]);
+      }
+      e += "]}";
+
+      mlock l (mutex_);
+
+      if (!loaded_)
+        load ();
+
+      auto r (entries_.emplace (output.string (), string ()));
+      string& v (r.first->second);
+
+      if (r.second || v != e)
+      {
+        v = move (e);
+        changed_ = true;
+      }
+    }
+
+    void compiledb::
+    erase (const path& output)
+    {
+      mlock l (mutex_);
+
+      if (!loaded_)
+        load ();
+
+      if (entries_.erase (output.string ()) != 0)
+        changed_ = true;
+    }
+
+    void compiledb::
+    load ()
+    {
+      loaded_ = true;
+
+      if (!file_exists (path_))
+        return;
+
+      try
+      {
+        ifdstream is (path_, ifdstream::badbit);
+
+        for (string l; !eof (getline (is, l)); )
+        {
+          // Each entry line starts with '{' and ends with '}' optionally
+          // followed by ','.
+          //
+          if (l.empty () || l[0] != '{')
+            continue;
+
+          if (l.back () == ',')
+            l.pop_back ();
+
+          string o (entry_output (l));
+
+          if (!o.empty ())
+            entries_.emplace (move (o), move (l));
+        }
+
+        is.close ();
+      }
+      catch (const io_error& e)
+      {
+        // Not fatal: we will just overwrite the database with what we have.
+        //
+        warn << "unable to read compilation database " << path_ << ": " << e;
+        changed_ = true;
+      }
+    }
+
+    void compiledb::
+    write ()
+    {
+      if (verb >= 2)
+        text << "cat >" << path_;
+
+      try
+      {
+        ofdstream os (path_);
+
+        os << '[' << '\n';
+
+        for (auto b (entries_.begin ()), i (b); i != entries_.end (); ++i)
+        {
+          if (i != b)
+            os << ',' << '\n';
+
+          os << i->second;
+        }
+
+        if (!entries_.empty ())
+          os << '\n';
+
+        os << ']' << '\n';
+
+        os.close ();
+      }
+      catch (const io_error& e)
+      {
+        fail << "unable to write compilation database " << path_ << ": " << e;
+      }
+
+      changed_ = false;
+    }
+
+    void compiledb::
+    write_all (action)
+    {
+      mlock l (databases_mutex);
+
+      for (auto& p: databases)
+      {
+        compiledb& db (*p.second);
+
+        mlock dl (db.mutex_);
+
+        if (db.changed_)
+          db.write ();
+      }
+    }
+  }
+}
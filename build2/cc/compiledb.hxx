@@ -0,0 +1,88 @@
+// file      : build2/cc/compiledb.hxx -*- C++ -*-
+// copyright : Copyright (c) 2014-2019 Code Synthesis Ltd
+// license   : MIT; see accompanying LICENSE file
+
+#ifndef BUILD2_CC_COMPILEDB_HXX
+#define BUILD2_CC_COMPILEDB_HXX
+
+#include <map>
+
+#include <build2/types.hxx>
+#include <build2/utility.hxx>
+
+#include <build2/action.hxx>
+
+namespace build2
+{
+  namespace cc
+  {
+    // Compilation database (compile_commands.json).
+    //
+    // Entries are added by the compile rule during match (that is, without
+    // running the compiler) and are kept in memory until the end of the
+    // operation batch at which point the database is written, but only if
+    // anything has changed. Entries for translation units that are not part
+    // of this build are preserved (and can only be removed by clean) which
+    // makes it possible to incrementally update the database from partial
+    // builds.
+    //
+    // While the database file is valid JSON, we write each entry on a
+    // separate line which allows us to merge it back without a JSON parser.
+    // Lines that we don't recognize on load are dropped.
+    //
+    class compiledb
+    {
+    public:
+      // Return the database for the specified path (should be absolute and
+      // normalized) creating it if necessary. Thread-safe.
+      //
+      static compiledb&
+      instance (const path&);
+
+      // Add or replace the entry for the specified output file. The source
+      // and output file paths should be absolute and normalized while the
+      // arguments are expected to be relative to relative_base (which is
+      // recorded as the entry's directory). The arguments should not be
+      // NULL-terminated. Thread-safe.
+      //
+      void
+      insert (const path& file, const path& output, const cstrings& args);
+
+      // Remove the entry for the specified output file, if any. Thread-safe.
+      //
+      void
+      erase (const path& output);
+
+      // Write all the databases that have changed. Registered as an operation
+      // end callback on the first call to instance().
+      //
+      static void
+      write_all (action);
+
+    private:
+      explicit
+      compiledb (path p): path_ (move (p)) {}
+
+      // Load the existing database, if any. Called with the mutex locked.
+      //
+      void
+      load ();
+
+      void
+      write ();
+
+    private:
+      const path path_;
+
+      mutex mutex_;
+      bool loaded_ = false;
+      bool changed_ = false;
+
+      // Output path to the entry's JSON object line.
+      //
+      std::map<string, string> entries_;
+    };
+  }
+}
+
+#endif // BUILD2_CC_COMPILEDB_HXX
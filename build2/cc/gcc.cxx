@@ -2,6 +2,8 @@
 // copyright : Copyright (c) 2014-2019 Code Synthesis Ltd
 // license   : MIT; see accompanying LICENSE file
 
+#include <map>
+
 #include <build2/scope.hxx>
 #include <build2/target.hxx>
 #include <build2/context.hxx>
@@ -24,6 +26,31 @@ namespace build2
   {
     using namespace bin;
 
+    // Extracting the search paths requires running the compiler and with
+    // many subprojects configured with the same toolchain we may end up
+    // doing it many times. So we cache the results keyed by the compiler
+    // command line. Note that module initialization happens during the
+    // serial load phase so no locking is necessary.
+    //
+    static std::map<string, dir_paths> search_paths_cache;
+
+    static string
+    search_paths_key (const process_path& xc, const cstrings& args)
+    {
+      string r (xc.effect_string ());
+
+      for (const char* a: args)
+      {
+        if (a != nullptr)
+        {
+          r += '\n';
+          r += a;
+        }
+      }
+
+      return r;
+    }
+
     // Extract system header search paths from GCC (gcc/g++) or compatible
     // (Clang, Intel) using the -v -E </dev/null method.
     //
@@ -61,6 +88,13 @@ namespace build2
       args.push_back ("-");
       args.push_back (nullptr);
 
+      string key (search_paths_key (xc, args));
+      {
+        auto i (search_paths_cache.find (key));
+        if (i != search_paths_cache.end ())
+          return i->second;
+      }
+
       if (verb >= 3)
         print_process (args);
 
@@ -154,6 +188,7 @@ namespace build2
         fail << "unable to extract " << x_lang << " compiler system header "
              << "search paths";
 
+      search_paths_cache[key] = r;
       return r;
     }
 
@@ -177,6 +212,13 @@ namespace build2
       args.push_back ("-print-search-dirs");
       args.push_back (nullptr);
 
+      string key (search_paths_key (xc, args));
+      {
+        auto i (search_paths_cache.find (key));
+        if (i != search_paths_cache.end ())
+          return i->second;
+      }
+
       if (verb >= 3)
         print_process (args);
 
@@ -258,6 +300,7 @@ namespace build2
           break;
       }
 
+      search_paths_cache[key] = r;
       return r;
     }
   }
@@ -14,6 +14,8 @@
 
 #include <build2/cc/target.hxx>
 #include <build2/cc/utility.hxx>
+#include <build2/cc/link-rule.hxx> // link_pool
+#include <build2/cc/compiledb.hxx>
 
 using namespace std;
 using namespace butl;
@@ -135,6 +137,15 @@ namespace build2
       v.insert<bool> ("config.cc.reprocess", true);
       v.insert<bool> ("cc.reprocess");
 
+      // Compilation database (compile_commands.json) path.
+      //
+      v.insert<path> ("config.cc.compiledb", true);
+      v.insert<path> ("cc.compiledb");
+
+      // Maximum number of concurrent (memory-heavy) links.
+      //
+      v.insert<uint64_t> ("config.cc.link.jobs", true);
+
       // Register scope operation callback.
       //
       // It feels natural to do clean up sidebuilds as a post operation but
@@ -263,6 +274,38 @@ namespace build2
       if (lookup l = config::omitted (rs, "config.cc.reprocess").first)
         rs.assign ("cc.reprocess") = *l;
 
+      // config.cc.compiledb
+      //
+      // A relative path is completed against the out_root of the outermost
+      // amalgamation so that by default all its subprojects share the same
+      // database.
+      //
+      if (lookup l = config::omitted (rs, "config.cc.compiledb").first)
+      {
+        path p (cast<path> (l));
+
+        if (p.relative ())
+          p = rs.weak_scope ()->out_path () / p;
+
+        p.normalize ();
+
+        compiledb::instance (p); // Register while still serial.
+        rs.assign<path> ("cc.compiledb") = move (p);
+      }
+
+      // config.cc.link.jobs
+      //
+      // The link pool is shared by all the projects in this build so we use
+      // the most restrictive limit if they happen to differ.
+      //
+      if (lookup l = config::omitted (rs, "config.cc.link.jobs").first)
+      {
+        size_t n (static_cast<size_t> (cast<uint64_t> (l)));
+
+        if (n != 0 && (link_pool.limit == 0 || n < link_pool.limit))
+          link_pool.limit = n;
+      }
+
       // Load the bin.config module.
       //
       if (!cast_false<bool> (rs["bin.config.loaded"]))
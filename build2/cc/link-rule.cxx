@@ -6,6 +6,7 @@
 
 #include <map>
 #include <cstdlib>  // exit()
+#include <cstring>  // strlen(), strpbrk()
 
 #include <libbutl/path-map.mxx>
 #include <libbutl/filesystem.mxx> // file_exists()
@@ -20,11 +21,13 @@
 
 #include <build2/bin/target.hxx>
 
-#include <build2/cc/target.hxx>  // c, pc*
+#include <build2/cc/target.hxx>  // c, pc*, dwp
 #include <build2/cc/utility.hxx>
 
 using std::map;
 using std::exit;
+using std::strlen;
+using std::strpbrk;
 
 using namespace butl;
 
@@ -34,10 +37,12 @@ namespace build2
   {
     using namespace bin;
 
+    scheduler::resource_pool link_pool;
+
     link_rule::
     link_rule (data&& d)
         : common (move (d)),
-          rule_id (string (x) += ".link 1")
+          rule_id (string (x) += ".link 2")
     {
       static_assert (sizeof (match_data) <= target::data_size,
                      "insufficient space");
@@ -746,6 +751,34 @@ namespace build2
             }
           }
 
+          // Add the split DWARF .dwp package if requested (see the compile
+          // rule for the .dwo part). We call it foo.dwp for an executable and
+          // libfoo.so.dwp for a shared library since that's where debuggers
+          // look for it. For the same reason we install it next to the
+          // binary.
+          //
+          if (!binless && ot != otype::a && tsys != "win32-msvc" &&
+              rs["bin.dwp.path"]                                  &&
+              (find_option ("-gsplit-dwarf", t, c_coptions) ||
+               find_option ("-gsplit-dwarf", t, x_coptions)))
+          {
+            target_lock dp (
+              add_adhoc_member (a, t,
+                                dwp::static_type,
+                                t.dir, t.out,
+                                t.path ().leaf ().string ()));
+
+            dp.target->as<file> ().derive_path ();
+
+            if (const variable* v = var_pool.find ("install"))
+            {
+              if (lookup l = t[*v])
+                dp.target->assign (*v) = *l;
+            }
+
+            match_recipe (dp, group_recipe); // Set recipe and unlock.
+          }
+
           // Add pkg-config's .pc file.
           //
           // Note that we do it regardless of whether we are installing or not
@@ -1571,6 +1604,105 @@ namespace build2
       }
     }
 
+    // Command line length above which we pass the inputs to the linker or
+    // archiver via a response file (@<file>). On Windows the limit is 32K
+    // characters for the whole command line. Elsewhere it is much higher but
+    // a huge argument vector still slows things down (and some tools, ar in
+    // particular, may choke on it).
+    //
+#ifdef _WIN32
+    static const size_t rsp_threshold (30000);
+#else
+    static const size_t rsp_threshold (131072);
+#endif
+
+    // Write the arguments into a response file quoting them as expected by
+    // the MSVC tools (Windows command line rules) or by GCC/Clang and the
+    // GNU/LLVM binutils (POSIX shell-like rules).
+    //
+    static void
+    write_response_file (const path& f,
+                         cstrings::const_iterator b,
+                         cstrings::const_iterator e,
+                         bool msvc)
+    {
+      if (verb >= 3)
+        text << "cat >" << f;
+
+      try
+      {
+        ofdstream os (f);
+
+        for (; b != e; ++b)
+        {
+          const char* a (*b);
+
+          if (msvc)
+          {
+            bool q (*a == '\0' || strpbrk (a, " \t\"") != nullptr);
+
+            if (q)
+              os << '"';
+
+            // Backslashes are literal unless they precede a double quote (or
+            // the closing quote) in which case they need to be doubled.
+            //
+            size_t bs (0);
+            for (; *a != '\0'; ++a)
+            {
+              if (*a == '\\')
+              {
+                ++bs;
+                continue;
+              }
+
+              if (*a == '"')
+                bs = bs * 2 + 1;
+
+              for (; bs != 0; --bs)
+                os << '\\';
+
+              os << *a;
+            }
+
+            if (q)
+              bs *= 2;
+
+            for (; bs != 0; --bs)
+              os << '\\';
+
+            if (q)
+              os << '"';
+          }
+          else
+          {
+            for (; *a != '\0'; ++a)
+            {
+              switch (*a)
+              {
+              case ' ':
+              case '\t':
+              case '\n':
+              case '\r':
+              case '\'':
+              case '"':
+              case '\\': os << '\\'; // Fall through.
+              default:   os << *a;
+              }
+            }
+          }
+
+          os << '\n';
+        }
+
+        os.close ();
+      }
+      catch (const io_error& e)
+      {
+        fail << "unable to write response file " << f << ": " << e;
+      }
+    }
+
     // Filter link.exe noise (msvc.cxx).
     //
     void
@@ -1754,6 +1886,17 @@ namespace build2
         }
       }
 
+      // If we are packaging split DWARF, then the .dwp file should be there
+      // (it may not if packaging has just been enabled).
+      //
+      const dwp* dwpt (find_adhoc_member<dwp> (t));
+
+      if (dwpt != nullptr && !update && !file_exists (dwpt->path ()))
+      {
+        l4 ([&]{trace << "missing " << *dwpt << " forcing update of " << t;});
+        update = true;
+      }
+
       // Check/update the dependency database.
       //
       // First should come the rule name/version.
@@ -1779,6 +1922,15 @@ namespace build2
 
         if (dd.expect (rl) != nullptr)
           l4 ([&]{trace << "ranlib mismatch forcing update of " << t;});
+
+        // We pass the members as paths relative to the working directory
+        // and some ar implementations store them as such (e.g., in thin
+        // archives). So to be able to update the archive incrementally (see
+        // below) we need to make sure it is still the same.
+        //
+        if (dd.expect (work.string ()) != nullptr)
+          l4 ([&]{trace << "working directory mismatch forcing update of "
+                        << t;});
       }
       else
       {
@@ -1829,7 +1981,10 @@ namespace build2
           //
           arg1 = ranlib ? "rc" : "rcs";
 
-          // For utility libraries use thin archives if possible.
+          // For utility libraries use thin archives if possible. For liba{}
+          // only do this if requested with bin.liba.thin and we are not
+          // updating for install (since a thin archive only references the
+          // object files, it is only usable locally).
           //
           // Thin archives are supported by GNU ar since binutils 2.19.1 and
           // LLVM ar since LLVM 3.8.0. Note that strictly speaking thin
@@ -1837,7 +1992,8 @@ namespace build2
           // probably safe to assume that the two came from the same version
           // of binutils/LLVM.
           //
-          if (lt.utility)
+          if (lt.utility ||
+              (!for_install && cast_false<bool> (t["bin.liba.thin"])))
           {
             const string& id (cast<string> (rs["bin.ar.id"]));
 
@@ -1977,6 +2133,26 @@ namespace build2
       // checksum is faster and simpler. And we like simple.
       //
       const file* def (nullptr); // Cached if present.
+
+      // For static libraries we try to replace only the members that have
+      // changed rather than re-creating the archive from scratch. Collect
+      // such members (and clear the flag if something prevents this).
+      //
+      // The incremental update is only possible if the set of members is the
+      // same (tracked via the file set checksum below) and all of them have
+      // distinct names (some ar implementations only store the leaf). We
+      // also only do this for GNU and LLVM ar that are known to handle it
+      // properly.
+      //
+      bool incr (false);
+      vector<const file*> changed;
+      if (lt.static_library () && tsys != "win32-msvc")
+      {
+        const string& id (cast<string> (rs["bin.ar.id"]));
+        incr = (id == "gnu" || id == "llvm");
+      }
+      paths leafs;
+
       {
         sha256 cs;
 
@@ -2023,9 +2199,15 @@ namespace build2
             {
               hash_libraries (cs, update, mt, *f, la, p.data, bs, a, li);
               f = nullptr; // Timestamp checked by hash_libraries().
+              incr = false;
             }
             else
+            {
               hash_path (cs, f->path (), rs.out_path ());
+
+              if (incr)
+                leafs.push_back (f->path ().leaf ());
+            }
           }
           else if ((f = pt->is_a<bin::def> ()))
           {
@@ -2043,12 +2225,28 @@ namespace build2
               f = nullptr; // Not an input.
           }
           else
+          {
             f = pt->is_a<exe> (); // Consider executable mtime (e.g., linker).
 
+            if (f != nullptr)
+              incr = false;
+          }
+
           // Check if this input renders us out of date.
           //
           if (f != nullptr)
-            update = update || f->newer (mt);
+          {
+            if (incr)
+            {
+              if (f->newer (mt))
+              {
+                changed.push_back (f);
+                update = true;
+              }
+            }
+            else
+              update = update || f->newer (mt);
+          }
         }
 
         // Treat it as input for both MinGW and VC (mtime checked above).
@@ -2084,6 +2282,22 @@ namespace build2
       if (!update)
         return ts;
 
+      // See if we can update the archive incrementally.
+      //
+      if (incr)
+      {
+        sort (leafs.begin (), leafs.end ());
+
+        incr = !scratch                     &&
+               mt != timestamp_nonexistent  &&
+               !changed.empty ()            &&
+               adjacent_find (leafs.begin (), leafs.end ()) == leafs.end ();
+
+        if (incr)
+          l5 ([&]{trace << "replacing " << changed.size () << " member(s) "
+                        << "of " << t;});
+      }
+
       // Ok, so we are updating. Finish building the command line.
       //
       string in, out, out1, out2, out3; // Storage.
@@ -2281,37 +2495,46 @@ namespace build2
 
       args[0] = ld->recall_string ();
 
-      // Append input files. The same logic as during hashing above.
+      // Append input files. The same logic as during hashing above unless
+      // we are only replacing the changed archive members.
       //
       // See also a similar loop inside append_libraries().
       //
-      for (const prerequisite_target& p: t.prerequisite_targets[a])
+      if (incr)
       {
-        const target* pt (p.target);
+        for (const file* f: changed)
+          sargs.push_back (relative (f->path ()).string ());
+      }
+      else
+      {
+        for (const prerequisite_target& p: t.prerequisite_targets[a])
+        {
+          const target* pt (p.target);
 
-        if (pt == nullptr)
-          continue;
+          if (pt == nullptr)
+            continue;
 
-        if (modules)
-        {
-          if (pt->is_a<bmix> ())
-            pt = pt->member;
-        }
+          if (modules)
+          {
+            if (pt->is_a<bmix> ())
+              pt = pt->member;
+          }
 
-        const file* f;
-        bool la (false), ls (false);
-
-        if ((f = pt->is_a<objx> ())           ||
-            (!lt.utility &&
-             (la = (f = pt->is_a<libux> ()))) ||
-            (!lt.static_library () &&
-             ((la = (f = pt->is_a<liba>  ())) ||
-              (ls = (f = pt->is_a<libs>  ())))))
-        {
-          if (la || ls)
-            append_libraries (sargs, *f, la, p.data, bs, a, li);
-          else
-            sargs.push_back (relative (f->path ()).string ()); // string()&&
+          const file* f;
+          bool la (false), ls (false);
+
+          if ((f = pt->is_a<objx> ())           ||
+              (!lt.utility &&
+               (la = (f = pt->is_a<libux> ()))) ||
+              (!lt.static_library () &&
+               ((la = (f = pt->is_a<liba>  ())) ||
+                (ls = (f = pt->is_a<libs>  ())))))
+          {
+            if (la || ls)
+              append_libraries (sargs, *f, la, p.data, bs, a, li);
+            else
+              sargs.push_back (relative (f->path ()).string ()); // string()&&
+          }
         }
       }
 
@@ -2323,6 +2546,8 @@ namespace build2
       // Shallow-copy sargs to args. Why not do it as we go along pushing into
       // sargs? Because of potential reallocations.
       //
+      size_t in_i (args.size ()); // Index of the first input (or rpath).
+
       for (const string& a: sargs)
         args.push_back (a.c_str ());
 
@@ -2332,6 +2557,36 @@ namespace build2
         append_options (args, t, x_libs);
       }
 
+      // If the command line is too long, then pass the inputs (and whatever
+      // follows them) via a response file. All the linkers and archivers we
+      // use support this except for some of the "generic" ar implementations
+      // (e.g., Apple's).
+      //
+      path rsp;         // Response file.
+      string rsp_arg;   // @<file> storage.
+      auto_rmfile rsp_rm;
+      {
+        size_t n (0);
+        for (const char* a: args)
+          n += strlen (a) + 1;
+
+        if (n > rsp_threshold &&
+            (!lt.static_library () ||
+             cast<string> (rs["bin.ar.id"]) != "generic"))
+        {
+          rsp = relt + ".rsp";
+
+          write_response_file (rsp,
+                               args.begin () + in_i, args.end (),
+                               tsys == "win32-msvc");
+          rsp_rm = auto_rmfile (rsp);
+
+          rsp_arg = '@' + rsp.string ();
+          args.resize (in_i);
+          args.push_back (rsp_arg.c_str ());
+        }
+      }
+
       args.push_back (nullptr);
 
       // Cleanup old (versioned) libraries.
@@ -2389,10 +2644,11 @@ namespace build2
         // We use relative paths to the object files which means we may end
         // up with different ones depending on CWD and some implementation
         // treat them as different archive members. So remote the file to
-        // be sure. Note that we ignore errors leaving it to the achiever
-        // to complain.
+        // be sure (unless we are replacing members incrementally in which
+        // case we've made sure CWD is the same). Note that we ignore errors
+        // leaving it to the achiever to complain.
         //
-        if (mt != timestamp_nonexistent)
+        if (mt != timestamp_nonexistent && !incr)
           try_rmfile (relt, true);
       }
 
@@ -2410,6 +2666,13 @@ namespace build2
 
       try
       {
+        // Limit the number of concurrent links, if requested. Archiving is
+        // cheap so we don't bother with static libraries. Note that the slot
+        // is only held while the linker is running.
+        //
+        scheduler::resource_guard rg (
+          sched, lt.static_library () ? nullptr : &link_pool);
+
         // VC tools (both lib.exe and link.exe) send diagnostics to stdout.
         // Also, link.exe likes to print various gratuitous messages. So for
         // link.exe we redirect stdout to a pipe, filter that noise out, and
@@ -2497,6 +2760,26 @@ namespace build2
         run (rl, args);
       }
 
+      // Package the split DWARF .dwo files that the binary refers to into
+      // .dwp (both GNU dwp and llvm-dwp support the -e option).
+      //
+      if (dwpt != nullptr)
+      {
+        const process_path& dp (cast<process_path> (rs["bin.dwp.path"]));
+        path relp (relative (dwpt->path ()));
+
+        const char* args[] = {
+          dp.recall_string (),
+          "-e", relt.string ().c_str (),
+          "-o", relp.string ().c_str (),
+          nullptr};
+
+        if (verb >= 2)
+          print_process (args);
+
+        run (dp, args);
+      }
+
       if (tclass == "windows")
       {
         // For Windows generate (or clean up) rpath-emulating assembly.
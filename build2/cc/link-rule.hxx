@@ -11,6 +11,7 @@
 #include <build2/utility.hxx>
 
 #include <build2/rule.hxx>
+#include <build2/scheduler.hxx>
 
 #include <build2/cc/types.hxx>
 #include <build2/cc/common.hxx>
@@ -19,6 +20,11 @@ namespace build2
 {
   namespace cc
   {
+    // Resource pool that limits the number of concurrent (memory-heavy)
+    // executable and shared library links. Set from config.cc.link.jobs.
+    //
+    extern scheduler::resource_pool link_pool;
+
     class link_rule: public rule, virtual common
     {
     public:
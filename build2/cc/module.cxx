@@ -510,8 +510,19 @@ namespace build2
         t.insert<pca> ();
         t.insert<pcs> ();
 
+        t.insert<dwo> ();
+        t.insert<dwp> ();
+
         if (install_loaded)
+        {
           install_path<pc> (rs, dir_path ("pkgconfig"));
+
+          // The .dwp files are installed next to the binary (the link rule
+          // takes care of that) while the .dwo files are not installed
+          // (object files are not either).
+          //
+          install_mode<dwp> (rs, "644");
+        }
       }
 
       // Register rules.
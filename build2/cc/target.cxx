@@ -97,5 +97,35 @@ namespace build2
       &file_search,
       false
     };
+
+    extern const char dwo_ext[] = "dwo"; // VC14 rejects constexpr.
+
+    const target_type dwo::static_type
+    {
+      "dwo",
+      &file::static_type,
+      &target_factory<dwo>,
+      &target_extension_fix<dwo_ext>,
+      nullptr, /* default_extension */
+      &target_pattern_fix<dwo_ext>,
+      &target_print_0_ext_verb, // Fixed extension, no use printing.
+      &file_search,
+      false
+    };
+
+    extern const char dwp_ext[] = "dwp"; // VC14 rejects constexpr.
+
+    const target_type dwp::static_type
+    {
+      "dwp",
+      &file::static_type,
+      &target_factory<dwp>,
+      &target_extension_fix<dwp_ext>,
+      nullptr, /* default_extension */
+      &target_pattern_fix<dwp_ext>,
+      &target_print_0_ext_verb, // Fixed extension, no use printing.
+      &file_search,
+      false
+    };
   }
 }
@@ -88,6 +88,30 @@ namespace build2
       static const target_type static_type;
       virtual const target_type& dynamic_type () const {return static_type;}
     };
+
+    // Split DWARF debug information (-gsplit-dwarf): the .dwo file produced
+    // by the compiler next to the object file and the .dwp package of all
+    // the .dwo files that make up an executable or a shared library.
+    //
+    class dwo: public file
+    {
+    public:
+      using file::file;
+
+    public:
+      static const target_type static_type;
+      virtual const target_type& dynamic_type () const {return static_type;}
+    };
+
+    class dwp: public file
+    {
+    public:
+      using file::file;
+
+    public:
+      static const target_type static_type;
+      virtual const target_type& dynamic_type () const {return static_type;}
+    };
   }
 }
 
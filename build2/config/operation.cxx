@@ -641,6 +641,8 @@ namespace build2
         if (out_root != src_root)
         {
           r = rmfile (out_root / src_root_file, 2) || r;
+          r = rmfile (out_root / durations_file, 2) || r;
+          r = rmfile (out_root / test_history_file, 2) || r;
 
           // Clean up the directories.
           //
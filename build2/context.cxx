@@ -10,6 +10,7 @@
 #include <build2/rule.hxx>
 #include <build2/scope.hxx>
 #include <build2/target.hxx>
+#include <build2/timeline.hxx>
 #include <build2/diagnostics.hxx>
 
 #include <libbutl/ft/exception.hxx> // uncaught_exceptions
@@ -33,6 +34,7 @@ namespace build2
   phase_mutex phase_mutex::instance;
 
   size_t load_generation;
+  size_t lookup_generation (1);
 
 #ifdef __cpp_thread_local
   thread_local
@@ -87,6 +89,7 @@ namespace build2
     {
       lm_.lock ();
       r = !fail_; // Re-query.
+      lookup_generation++;
     }
 
     return r;
@@ -126,6 +129,12 @@ namespace build2
         else if (ec_ != 0) {phase = run_phase::execute; v = &ev_;}
         else               {phase = run_phase::load;    v = nullptr;}
 
+        // Falling back to load is also a switch to load (think the driver
+        // loading the next operation batch).
+        //
+        if (phase == run_phase::load)
+          lookup_generation++;
+
         if (v != nullptr)
         {
           l.unlock ();
@@ -196,6 +205,7 @@ namespace build2
     {
       lm_.lock ();
       r = !fail_; // Re-query.
+      lookup_generation++;
     }
 
     return r;
@@ -283,16 +293,122 @@ namespace build2
 
   // phase_switch
   //
+  static mutex phase_switch_stat_mutex;
+  static phase_switch_stat phase_switch_stat_;
+
+  phase_switch_stat
+  phase_switch_statistics ()
+  {
+    mlock l (phase_switch_stat_mutex);
+    return phase_switch_stat_;
+  }
+
+  static void
+  record_phase_switch (const phase_switch& ps)
+  {
+    // Print the target outside of the lock but only if it is a candidate
+    // for the longest list.
+    //
+    string t;
+    if (ps.trigger != nullptr)
+    {
+      bool c;
+      {
+        mlock l (phase_switch_stat_mutex);
+        const auto& v (phase_switch_stat_.longest);
+        c = v.size () < phase_switch_stat::longest_max ||
+            v.back ().first < ps.stall;
+      }
+
+      if (c)
+      {
+        ostringstream os;
+        os << *ps.trigger;
+        t = os.str ();
+      }
+    }
+
+    mlock l (phase_switch_stat_mutex);
+    phase_switch_stat& s (phase_switch_stat_);
+
+    switch (ps.n)
+    {
+    case run_phase::load:
+      {
+        s.load_switches++;
+        s.load_stall += ps.stall;
+        break;
+      }
+    case run_phase::execute:
+      {
+        s.execute_switches++;
+        s.execute_targets += ps.targets;
+        s.execute_stall += ps.stall;
+        break;
+      }
+    case run_phase::match:
+      return; // Not something we track.
+    }
+
+    if (!t.empty ())
+    {
+      auto& v (s.longest);
+      auto i (find_if (v.begin (), v.end (),
+                       [&ps] (const pair<duration, string>& p)
+                       {
+                         return p.first < ps.stall;
+                       }));
+
+      if (i != v.end () || v.size () < phase_switch_stat::longest_max)
+      {
+        v.insert (i, make_pair (ps.stall, move (t)));
+
+        if (v.size () > phase_switch_stat::longest_max)
+          v.pop_back ();
+      }
+    }
+  }
+
+  // Record the wait for the phase switch on the timeline.
+  //
+  static void
+  timeline_phase_switch (run_phase from, run_phase to,
+                         timestamp s, timestamp e,
+                         const target* t)
+  {
+    if (!timeline_enabled ())
+      return;
+
+    ostringstream os;
+    os << "switch " << from << " to " << to;
+
+    timeline_args as;
+    if (t != nullptr)
+    {
+      ostringstream ts;
+      ts << *t;
+      as.push_back (make_pair ("target", ts.str ()));
+    }
+
+    timeline_record ("phase", os.str (), s, e, move (as));
+  }
+
   phase_switch::
-  phase_switch (run_phase n)
-      : o (phase), n (n)
+  phase_switch (run_phase n, const target* t, size_t c)
+      : o (phase), n (n), trigger (t), targets (c)
   {
+    timestamp s (system_clock::now ());
+
     if (!phase_mutex::instance.relock (o, n))
     {
       phase_mutex::instance.relock (n, o);
       throw failed ();
     }
 
+    timestamp e (system_clock::now ());
+    stall = e - s;
+    timeline_phase_switch (o, n, s, e, t);
+
     phase_lock::instance->p = n;
 
     if (n == run_phase::load) // Note: load lock is exclusive.
@@ -314,9 +430,17 @@ namespace build2
       phase_mutex::instance.fail_ = true;
     }
 
+    timestamp s (system_clock::now ());
     bool r (phase_mutex::instance.relock (n, o));
     phase_lock::instance->p = o;
 
+    timestamp e (system_clock::now ());
+    stall += e - s;
+    timeline_phase_switch (n, o, s, e, trigger);
+
+    if (!uncaught_exception ())
+      record_phase_switch (*this);
+
     // Similar logic to ~phase_unlock().
     //
     if (!r && !uncaught_exception ())
@@ -363,8 +487,12 @@ namespace build2
   atomic_count target_count;
   atomic_count skip_count;
 
+  vector<function<operation_end_callback>> operation_end_callbacks;
+
   bool keep_going = false;
 
+  bool load_on_demand = false;
+
   variable_overrides
   reset (const strings& cmd_vars)
   {
@@ -381,6 +509,11 @@ namespace build2
     variable_overrides vos;
 
     targets.clear ();
+
+    if (memory_enabled ())
+      memory_deallocate (memory_subsystem::scopes,
+                         sm.size () * sizeof (scope_map::value_type));
+
     sm.clear ();
     vp.clear ();
 
@@ -700,7 +833,7 @@ namespace build2
       //
       if (o->override == nullptr)
         const_cast<variable*> (o)->override.reset (
-          new variable {n + k, nullptr , nullptr, nullptr, v});
+          new variable {n + k, nullptr , nullptr, nullptr, v, 0});
 
       o = o->override.get ();
 
@@ -53,6 +53,12 @@ namespace build2
   extern run_phase phase;
   extern size_t load_generation;
 
+  // Incremented on each switch to the load phase (including the initial
+  // one, falling back to load once no phase is locked, and the driver's
+  // loads) and used to invalidate lookup caches (see scope_lookup_cache).
+  //
+  extern size_t lookup_generation;
+
   // A "tri-mutex" that keeps all the threads in one of the three phases. When
   // a thread wants to switch a phase, it has to wait for all the other
   // threads to do the same (or release their phase locks). The load phase is
@@ -226,14 +232,50 @@ namespace build2
   // Assuming we have a lock on the current phase, temporarily switch to a
   // new phase and switch back on destruction.
   //
+  // The target that triggered the switch (if any) and the number of targets
+  // that will be handled in the new phase are only used for statistics (see
+  // phase_switch_stat below).
+  //
+  class target;
+
   struct phase_switch
   {
-    explicit phase_switch (run_phase);
+    explicit
+    phase_switch (run_phase, const target* = nullptr, size_t targets = 1);
     ~phase_switch () noexcept (false);
 
     run_phase o, n;
+
+    const target* trigger;
+    size_t targets;
+    duration stall; // Time spent waiting for the new phase.
+  };
+
+  // Phase switch statistics (printed with --stat).
+  //
+  // The stall time is the time the switching thread spent waiting for all
+  // the other threads to leave the current phase, both when switching to
+  // the new phase and back. The longest stalls are recorded together with
+  // the targets that triggered them.
+  //
+  struct phase_switch_stat
+  {
+    size_t load_switches = 0;
+    size_t execute_switches = 0;
+    size_t execute_targets = 0;  // Targets executed during execute switches.
+
+    duration load_stall = duration::zero ();
+    duration execute_stall = duration::zero ();
+
+    static const size_t longest_max = 10;
+    vector<pair<duration, string>> longest; // Longest first.
   };
 
+  // Return a snapshot of the statistics. Thread-safe.
+  //
+  phase_switch_stat
+  phase_switch_statistics ();
+
   // Wait for a task count optionally and temporarily unlocking the phase.
   //
   struct wait_guard
@@ -394,6 +436,18 @@ namespace build2
     skip_count.store (0, memory_order_relaxed);
   }
 
+  // Operation end callbacks.
+  //
+  // Called serially at the end of each operation batch, after the targets
+  // have been matched and executed. Normally used by modules to flush state
+  // accumulated during match and/or execute (for example, the compilation
+  // database). Note that the callbacks are not cleared by reset() and so
+  // should not reference any build state.
+  //
+  using operation_end_callback = void (action);
+
+  extern vector<function<operation_end_callback>> operation_end_callbacks;
+
   // Keep going flag.
   //
   // Note that setting it to false is not of much help unless we are running
@@ -402,6 +456,11 @@ namespace build2
   //
   extern bool keep_going;
 
+  // Load on demand flag (see --load-on-demand and load_deferred() for
+  // details).
+  //
+  extern bool load_on_demand;
+
   // Reset the build state. In particular, this removes all the targets,
   // scopes, and variables.
   //
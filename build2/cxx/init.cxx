@@ -406,6 +406,7 @@ namespace build2
         v["cc.system"],
         v["cc.module_name"],
         v["cc.reprocess"],
+        v["cc.compiledb"],
 
         // Ability to signal that source is already (partially) preprocessed.
         // Valid values are 'none' (not preprocessed), 'includes' (no #include
@@ -10,6 +10,8 @@
 #  include <libbutl/win32-utility.hxx>
 #endif
 
+#include <build2/memory.hxx>
+#include <build2/timeline.hxx>
 #include <build2/diagnostics.hxx>
 
 using namespace std;
@@ -20,6 +22,12 @@ namespace build2
   depdb_base::
   depdb_base (const path& p, timestamp mt)
   {
+    memory_guard mg (memory_subsystem::depdb);
+
+    timeline_span ts ("depdb");
+    if (ts)
+      ts.name = "open " + p.string ();
+
     fdopen_mode om (fdopen_mode::out | fdopen_mode::binary);
     ifdstream::iostate em (ifdstream::badbit);
 
@@ -139,6 +147,8 @@ namespace build2
   string* depdb::
   read_ ()
   {
+    memory_guard mg (memory_subsystem::depdb);
+
     // Save the start position of this line so that we can overwrite it.
     //
     pos_ = buf_->tellg ();
@@ -244,6 +254,10 @@ namespace build2
   void depdb::
   close ()
   {
+    timeline_span ts ("depdb");
+    if (ts)
+      ts.name = "close " + path.string ();
+
     // If we are at eof, then it means all lines are good, there is the "end
     // marker" at the end, and we don't need to do anything, except, maybe
     // touch the file. Otherwise, if we are still in the read mode, truncate
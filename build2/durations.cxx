@@ -0,0 +1,143 @@
+// file      : build2/durations.cxx -*- C++ -*-
+// copyright : Copyright (c) 2014-2019 Code Synthesis Ltd
+// license   : MIT; see accompanying LICENSE file
+
+#include <build2/durations.hxx>
+
+#include <build2/file.hxx>
+#include <build2/scope.hxx>
+#include <build2/filesystem.hxx>
+#include <build2/diagnostics.hxx>
+
+using namespace std;
+using namespace butl;
+
+namespace build2
+{
+  durations& durations::
+  instance (const scope& rs)
+  {
+    return project_database::instance<durations> (rs, durations_file);
+  }
+
+  durations::
+  durations (dir_path d, path f)
+      : project_database (move (d), move (f))
+  {
+    load ();
+  }
+
+  uint64_t durations::
+  find (const path& p) const
+  {
+    auto i (previous_.find (p.string ()));
+    return i != previous_.end () ? i->second : 0;
+  }
+
+  void durations::
+  insert (const path& p, duration d)
+  {
+    using namespace chrono;
+
+    uint64_t us (duration_cast<microseconds> (d).count ());
+
+    if (us == 0)
+      us = 1; // Distinguish from unknown.
+
+    mlock l (mutex_);
+    current_[p.string ()] = us;
+  }
+
+  void durations::
+  load ()
+  {
+    if (!loadable ())
+      return;
+
+    try
+    {
+      ifdstream is (path_, ifdstream::badbit);
+
+      for (string l; !eof (getline (is, l)); )
+      {
+        size_t p (l.find (' '));
+
+        if (p == string::npos || p == 0 || p + 1 == l.size ())
+          continue; // Skip invalid lines.
+
+        uint64_t us (0);
+        try
+        {
+          us = stoull (string (l, 0, p));
+        }
+        catch (const invalid_argument&) {continue;}
+        catch (const out_of_range&) {continue;}
+
+        previous_[(out_root_ / path (string (l, p + 1))).string ()] = us;
+      }
+
+      is.close ();
+    }
+    catch (const invalid_path&)
+    {
+      // Not fatal: the database will be overwritten with the new entries.
+    }
+    catch (const io_error& e)
+    {
+      warn << "unable to read durations database " << path_ << ": " << e;
+    }
+  }
+
+  void durations::
+  write_changed ()
+  {
+    mlock l (mutex_);
+
+    if (current_.empty ())
+      return;
+
+    for (auto& p: current_)
+      previous_[p.first] = p.second;
+
+    current_.clear ();
+
+    if (!writable ())
+      return;
+
+    if (verb >= 3)
+      text << "cat >" << path_;
+
+    try
+    {
+      ofdstream os (path_);
+
+      const string& r (out_root_.string ());
+
+      for (const auto& p: previous_)
+      {
+        const string& f (p.first);
+
+        // Only keep the entries for the targets in this project (the path
+        // is absolute and normalized so this test is sufficient).
+        //
+        if (f.size () > r.size () && f.compare (0, r.size (), r) == 0)
+        {
+          size_t n (r.size ());
+          if (path::traits::is_separator (f[n]))
+            ++n;
+
+          os << p.second << ' ' << string (f, n) << '\n';
+        }
+      }
+
+      os.close ();
+    }
+    catch (const io_error& e)
+    {
+      // Not fatal: we will just schedule in the declaration order next
+      // time.
+      //
+      warn << "unable to write durations database " << path_ << ": " << e;
+    }
+  }
+}
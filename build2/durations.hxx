@@ -0,0 +1,77 @@
+// file      : build2/durations.hxx -*- C++ -*-
+// copyright : Copyright (c) 2014-2019 Code Synthesis Ltd
+// license   : MIT; see accompanying LICENSE file
+
+#ifndef BUILD2_DURATIONS_HXX
+#define BUILD2_DURATIONS_HXX
+
+#include <unordered_map>
+
+#include <build2/types.hxx>
+#include <build2/utility.hxx>
+
+#include <build2/project-database.hxx>
+
+namespace build2
+{
+  class scope;
+
+  // Target execution durations database.
+  //
+  // Records how long it took to execute (update, etc) file-based targets
+  // that have changed. Because the recipe execution includes waiting for
+  // the target's prerequisites, this duration is an estimate of the longest
+  // path through the target's dependency graph and is used on the next run
+  // to schedule the prerequisites on the critical path first (see
+  // execute_prerequisites() for details).
+  //
+  // The database for each project is stored in out_root/build/durations,
+  // one entry per line in the <microseconds> <path> form with paths being
+  // relative to out_root. It is written at the end of the operation batch
+  // but only if anything has changed (see project_database for details).
+  //
+  class durations: public project_database
+  {
+  public:
+    // Return the database for the project with the specified root scope,
+    // loading it if necessary. Thread-safe.
+    //
+    static durations&
+    instance (const scope& root);
+
+    // Return the duration (in microseconds) recorded for the specified
+    // target path by a previous run or 0 if unknown. Thread-safe.
+    //
+    uint64_t
+    find (const path&) const;
+
+    // Record the duration for the specified target path. Thread-safe.
+    //
+    void
+    insert (const path&, duration);
+
+  private:
+    friend class project_database;
+
+    durations (dir_path out_root, path file);
+
+    void
+    load ();
+
+    virtual void
+    write_changed () override;
+
+  private:
+    // Entries keyed by absolute path. The previous entries are loaded
+    // during construction and are not modified until the end of the
+    // operation (so can be looked up without locking). The current ones
+    // are merged into them once written.
+    //
+    std::unordered_map<string, uint64_t> previous_;
+
+    mutex mutex_;
+    std::unordered_map<string, uint64_t> current_;
+  };
+}
+
+#endif // BUILD2_DURATIONS_HXX
@@ -9,6 +9,7 @@
 #include <build2/scope.hxx>
 #include <build2/target.hxx>
 #include <build2/context.hxx>
+#include <build2/timeline.hxx>
 #include <build2/filesystem.hxx>   // exists()
 #include <build2/prerequisite.hxx>
 #include <build2/diagnostics.hxx>
@@ -40,6 +41,9 @@ namespace build2
   //
   const path config_file (build_dir / "config.build");
 
+  const path durations_file    (build_dir / "durations");
+  const path test_history_file (build_dir / "test-history");
+
   const path buildfile_file ("buildfile");
 
   ostream&
@@ -121,6 +125,10 @@ namespace build2
   {
     tracer trace ("source");
 
+    timeline_span ts ("load");
+    if (ts)
+      ts.name = bf.string ();
+
     try
     {
       bool sin (bf.string () == "-");
@@ -162,10 +170,90 @@ namespace build2
       return false;
     }
 
+    // Now that it is loaded it is no longer deferred (this can happen, for
+    // example, if a deferred subdirectory is loaded as a dir{} prerequisite).
+    //
+    if (!base.deferred_buildfile.empty () && base.deferred_buildfile == bf)
+      base.deferred_buildfile.clear ();
+
     source (root, base, bf);
     return true;
   }
 
+  bool
+  defer_buildfile (scope& root, scope& base, const path& bf)
+  {
+    if (root.buildfiles.find (bf) != root.buildfiles.end () ||
+        !base.deferred_buildfile.empty ())
+      return false;
+
+    base.deferred_buildfile = bf;
+    return true;
+  }
+
+  // Return the innermost scope that contains the specified directory and has
+  // a deferred buildfile or NULL if there is none.
+  //
+  static const scope*
+  deferred_scope (const dir_path& d)
+  {
+    for (const scope* s (&scopes.find (d));
+         s != nullptr;
+         s = s->parent_scope ())
+    {
+      if (!s->deferred_buildfile.empty ())
+        return s;
+    }
+
+    return nullptr;
+  }
+
+  bool
+  load_deferred (const dir_path& d)
+  {
+    tracer trace ("load_deferred");
+
+    // Note that the deferred state is only modified during the (exclusive)
+    // load phase so we can examine it without any locking.
+    //
+    if (deferred_scope (d) == nullptr)
+      return false;
+
+    bool r (false);
+
+    assert (phase == run_phase::match);
+    {
+      phase_switch ps (run_phase::load);
+
+      // Another thread may have loaded some or all of them while we were
+      // switching the phase so re-examine. Note also that loading a
+      // buildfile can defer more buildfiles for its subdirectories.
+      //
+      for (const scope* s; (s = deferred_scope (d)) != nullptr; )
+      {
+        scope& base (s->rw ());
+        scope& root (*base.root_scope ());
+
+        path bf (base.deferred_buildfile);
+
+        l5 ([&]{trace << "loading buildfile " << bf << " for " << d;});
+
+        if (source_once (root, base, bf, root))
+          r = true;
+        else
+        {
+          // Already sourced (for example, via a relative include from a
+          // different directory), so just drop it.
+          //
+          base.deferred_buildfile.clear ();
+        }
+      }
+    }
+    assert (phase == run_phase::match);
+
+    return r;
+  }
+
   // Source (once) pre-*.build (pre is true) or post-*.build (otherwise) hooks
   // from the specified subdirectory (build/bootstrap/ or build/root/) of
   // out_root/.
@@ -34,6 +34,8 @@ namespace build2
   extern const path out_root_file;     // build/bootstrap/out-root.build
   extern const path export_file;       // build/export.build
   extern const path config_file;       // build/config.build
+  extern const path durations_file;    // build/durations
+  extern const path test_history_file; // build/test-history
 
   extern const path buildfile_file;    // buildfile
 
@@ -80,6 +82,22 @@ namespace build2
   bool
   source_once (scope& root, scope& base, const path&, scope& once);
 
+  // Defer loading of the buildfile for the specified base scope until a
+  // target in this scope (or in one of its not yet loaded subscopes) is
+  // searched for during match (see --load-on-demand). Return false if this
+  // buildfile has already been loaded or deferred.
+  //
+  bool
+  defer_buildfile (scope& root, scope& base, const path&);
+
+  // Load the deferred buildfiles, if any, that may define targets in the
+  // specified out directory, switching to the load phase if necessary.
+  // Return true if anything has been loaded. Should be called during the
+  // match phase.
+  //
+  bool
+  load_deferred (const dir_path& out_base);
+
   // Create project's root scope. Only set the src_root variable if the passed
   // src_root value is not empty. The scope argument is only used as proof of
   // lock.
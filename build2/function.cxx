@@ -6,6 +6,9 @@
 
 #include <cstring> // strchr()
 
+#include <build2/memory.hxx>
+#include <build2/context.hxx> // phase
+
 using namespace std;
 
 namespace build2
@@ -93,9 +96,34 @@ namespace build2
     auto i (map_.emplace (move (name), move (f)));
 
     i->second.name = i->first.c_str ();
+
+    // Enter into the dispatch table invalidating cached resolutions.
+    //
+    dispatch& d (table_[i->first]);
+    d.overloads.push_back (&i->second);
+    d.resolutions.clear ();
+
     return i;
   }
 
+  void function_map::
+  erase (iterator i)
+  {
+    auto j (table_.find (i->first));
+    assert (j != table_.end ());
+
+    dispatch& d (j->second);
+
+    auto& os (d.overloads);
+    os.erase (find (os.begin (), os.end (), &i->second));
+    d.resolutions.clear ();
+
+    if (os.empty ())
+      table_.erase (j);
+
+    map_.erase (i);
+  }
+
   pair<value, bool> function_map::
   call (const scope* base,
         const string& name,
@@ -103,6 +131,8 @@ namespace build2
         const location& loc,
         bool fa) const
   {
+    memory_guard mg (memory_subsystem::functions);
+
     auto print_call = [&name, &args] (ostream& os)
     {
       os << name << '(';
@@ -126,16 +156,53 @@ namespace build2
     //
     // More than one match of the same rank is ambiguous.
     //
-    auto ip (map_.equal_range (name));
+    // First see if we have already resolved a call with these argument
+    // types.
+    //
+    const dispatch* d (nullptr);
+    {
+      auto i (table_.find (name));
+      if (i != table_.end ())
+        d = &i->second;
+    }
+
+    auto same_types = [&args] (const arg_types& ts)
+    {
+      if (ts.size () != args.size ())
+        return false;
+
+      for (size_t i (0); i != ts.size (); ++i)
+      {
+        if (ts[i] != args[i].type)
+          return false;
+      }
+
+      return true;
+    };
 
     size_t rank (~0);
     small_vector<const function_overload*, 2> ovls;
+
+    if (d != nullptr)
+    {
+      for (const resolution& r: d->resolutions)
+      {
+        if (same_types (r.types))
+        {
+          rank = r.rank;
+          ovls.push_back (r.overload);
+          break;
+        }
+      }
+    }
+
+    if (d != nullptr && ovls.empty ())
     {
       size_t count (args.size ());
 
-      for (auto it (ip.first); it != ip.second; ++it)
+      for (const function_overload* pf: d->overloads)
       {
-        const function_overload& f (it->second);
+        const function_overload& f (*pf);
 
         // Argument count match.
         //
@@ -199,6 +266,24 @@ namespace build2
 
         // Continue looking to detect ambiguities.
       }
+
+      // Cache the unambiguous match. We only do this during the (serial)
+      // load phase so that the cache can be read without locking in other
+      // phases (for example, from testscripts).
+      //
+      if (ovls.size () == 1 && phase == run_phase::load)
+      {
+        auto& rs (d->resolutions);
+
+        if (rs.size () < resolutions_max)
+        {
+          arg_types ts;
+          for (size_t i (0); i != args.size (); ++i)
+            ts.push_back (args[i].type);
+
+          rs.push_back (resolution {move (ts), ovls.back (), rank});
+        }
+      }
     }
 
     switch (ovls.size ())
@@ -264,6 +349,8 @@ namespace build2
 
         dr << fail (loc) << "unmatched call to "; print_call (dr.os);
 
+        auto ip (map_.equal_range (name));
+
         for (auto i (ip.first); i != ip.second; ++i)
           dr << info << "candidate: " << i->second;
 
@@ -7,6 +7,7 @@
 
 #include <map>
 #include <utility>       // index_sequence
+#include <unordered_map>
 #include <type_traits>   // aligned_storage
 
 #include <build2/types.hxx>
@@ -161,7 +162,7 @@ namespace build2
     insert (string name, function_overload);
 
     void
-    erase (iterator i) {map_.erase (i);}
+    erase (iterator);
 
     value
     call (const scope* base,
@@ -214,6 +215,40 @@ namespace build2
           bool fail) const;
 
     map_type map_;
+
+    // Function dispatch table.
+    //
+    // Maps each function name to the list of its overloads. Since the
+    // overload resolution only depends on the argument types, we also cache
+    // its (unambiguous) results for each name so that a repeated call with
+    // the same argument types (normally from the same call site, for
+    // example, in a loop) does not have to redo it.
+    //
+    // Note that, similar to map_, the table (including the resolution
+    // cache) is only modified during the serial load phase and so can be
+    // read without locking in other phases (for example, from testscripts).
+    //
+    using arg_types = small_vector<const value_type*, 4>;
+
+    struct resolution
+    {
+      arg_types types;
+      const function_overload* overload;
+      size_t rank;
+    };
+
+    struct dispatch
+    {
+      small_vector<const function_overload*, 4> overloads;
+      mutable small_vector<resolution, 2> resolutions;
+    };
+
+    std::unordered_map<string, dispatch> table_;
+
+    // Maximum number of resolutions cached per function name (calls with
+    // variadic arguments may result in many distinct signatures).
+    //
+    static const size_t resolutions_max = 8;
   };
 
   extern function_map functions;
@@ -32,12 +32,39 @@ namespace build2
     return make_pair (move (n), move (e));
   }
 
+  // Apply the function to the target'ish version of each name in the list.
+  // If the list contains a single name, then return the (typed) result as
+  // is. Otherwise, transform the list in place into an untyped list of the
+  // results.
+  //
+  template <typename F>
+  static value
+  transform_names (const scope* s, names&& ns, const F& f)
+  {
+    if (ns.size () == 1)
+      return value (f (to_target (s, move (ns.front ())).first));
+
+    for (name& n: ns)
+    {
+      if (n.pair)
+        throw invalid_argument ("pair in name list");
+
+      n = name (f (to_target (s, move (n)).first));
+    }
+
+    return value (move (ns));
+  }
+
   void
   name_functions ()
   {
     function_family f ("name");
 
-    // These functions treat a name as a target/prerequisite name.
+    // These functions treat a name as a target/prerequisite name. The
+    // name(), directory(), and target_type() functions can also be called
+    // on a list of names in which case they return the list of results.
+    // Note that extension() and project() only accept a single name since
+    // their result can be NULL which we cannot represent in a list.
     //
     // While on one hand it feels like calling them target.name(), etc., would
     // have been more appropriate, on the other hand they can also be called
@@ -51,7 +78,8 @@ namespace build2
     };
     f["name"] = [](const scope* s, names ns)
     {
-      return to_target (s, convert<name> (move (ns))).first.value;
+      return transform_names (s, move (ns),
+                              [] (name&& n) {return move (n.value);});
     };
 
     // Note: returns NULL if extension is unspecified (default) and empty if
@@ -72,7 +100,8 @@ namespace build2
     };
     f["directory"] = [](const scope* s, names ns)
     {
-      return to_target (s, convert<name> (move (ns))).first.dir;
+      return transform_names (s, move (ns),
+                              [] (name&& n) {return move (n.dir);});
     };
 
     f["target_type"] = [](const scope* s, name n)
@@ -81,7 +110,8 @@ namespace build2
     };
     f["target_type"] = [](const scope* s, names ns)
     {
-      return to_target (s, convert<name> (move (ns))).first.type;
+      return transform_names (s, move (ns),
+                              [] (name&& n) {return move (n.type);});
     };
 
     // Note: returns NULL if no project specified.
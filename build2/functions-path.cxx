@@ -78,6 +78,38 @@ namespace build2
     return value (move (r));
   }
 
+  // Transform a list of untyped names in place. For each name decide based
+  // on the presence of a trailing slash whether it is a directory and call
+  // the corresponding function to transform it. Return as untyped list of
+  // (potentially mixed) paths.
+  //
+  // Note that the path is moved out of and back into the name so there is no
+  // copying (other than what the transformation itself might do).
+  //
+  template <typename D, typename P>
+  static names
+  transform_names (names&& ns, const D& df, const P& pf)
+  {
+    for (name& n: ns)
+    {
+      if (n.directory ())
+        df (n.dir);
+      else
+      {
+        path p (convert<path> (move (n)));
+        pf (p);
+
+        // The name could have been split into the directory and value parts
+        // (e.g., a/{b}) in which case the path is the reassembled version.
+        //
+        n.dir.clear ();
+        n.value = move (p).string ();
+      }
+    }
+
+    return move (ns);
+  }
+
   template <typename P>
   static inline P
   leaf (const P& p, const optional<dir_path>& d)
@@ -107,6 +139,7 @@ namespace build2
     f["string"] = [](paths v)
     {
       strings r;
+      r.reserve (v.size ());
       for (auto& p: v)
         r.push_back (move (p).string ());
       return r;
@@ -115,6 +148,7 @@ namespace build2
     f["string"] = [](dir_paths v)
     {
       strings r;
+      r.reserve (v.size ());
       for (auto& p: v)
         r.push_back (move (p).string ());
       return r;
@@ -127,6 +161,7 @@ namespace build2
     f["representation"] = [](paths v)
     {
       strings r;
+      r.reserve (v.size ());
       for (auto& p: v)
         r.push_back (move (p).representation ());
       return r;
@@ -135,6 +170,7 @@ namespace build2
     f["representation"] = [](dir_paths v)
     {
       strings r;
+      r.reserve (v.size ());
       for (auto& p: v)
         r.push_back (move (p).representation ());
       return r;
@@ -161,18 +197,9 @@ namespace build2
 
     f[".canonicalize"] = [](names ns)
     {
-      // For each path decide based on the presence of a trailing slash
-      // whether it is a directory. Return as untyped list of (potentially
-      // mixed) paths.
-      //
-      for (name& n: ns)
-      {
-        if (n.directory ())
-          n.dir.canonicalize ();
-        else
-          n.value = convert<path> (move (n)).canonicalize ().string ();
-      }
-      return ns;
+      return transform_names (move (ns),
+                              [] (dir_path& d) {d.canonicalize ();},
+                              [] (path& p) {p.canonicalize ();});
     };
 
     // normalize
@@ -211,18 +238,9 @@ namespace build2
     {
       bool act (a && convert<bool> (move (*a)));
 
-      // For each path decide based on the presence of a trailing slash
-      // whether it is a directory. Return as untyped list of (potentially
-      // mixed) paths.
-      //
-      for (name& n: ns)
-      {
-        if (n.directory ())
-          n.dir.normalize (act);
-        else
-          n.value = convert<path> (move (n)).normalize (act).string ();
-      }
-      return ns;
+      return transform_names (move (ns),
+                              [act] (dir_path& d) {d.normalize (act);},
+                              [act] (path& p) {p.normalize (act);});
     };
 
     // directory
@@ -232,6 +250,7 @@ namespace build2
     f["directory"] = [](paths v)
     {
       dir_paths r;
+      r.reserve (v.size ());
       for (const path& p: v)
         r.push_back (p.directory ());
       return r;
@@ -279,18 +298,9 @@ namespace build2
 
     f[".base"] = [](names ns)
     {
-      // For each path decide based on the presence of a trailing slash
-      // whether it is a directory. Return as untyped list of (potentially
-      // mixed) paths.
-      //
-      for (name& n: ns)
-      {
-        if (n.directory ())
-          n.dir = n.dir.base ();
-        else
-          n.value = convert<path> (move (n)).base ().string ();
-      }
-      return ns;
+      return transform_names (move (ns),
+                              [] (dir_path& d) {d = d.base ();},
+                              [] (path& p) {p = p.base ();});
     };
 
     // leaf
@@ -318,18 +328,9 @@ namespace build2
 
     f[".leaf"] = [](names ns, optional<dir_path> d)
     {
-      // For each path decide based on the presence of a trailing slash
-      // whether it is a directory. Return as untyped list of (potentially
-      // mixed) paths.
-      //
-      for (name& n: ns)
-      {
-        if (n.directory ())
-          n.dir = leaf (n.dir, d);
-        else
-          n.value = leaf (convert<path> (move (n)), d).string ();
-      }
-      return ns;
+      return transform_names (move (ns),
+                              [&d] (dir_path& p) {p = leaf (p, d);},
+                              [&d] (path& p) {p = leaf (p, d);});
     };
 
     // extension
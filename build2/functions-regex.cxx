@@ -2,7 +2,9 @@
 // copyright : Copyright (c) 2014-2019 Code Synthesis Ltd
 // license   : MIT; see accompanying LICENSE file
 
+#include <list>
 #include <sstream>
+#include <unordered_map>
 
 #include <libbutl/regex.mxx>
 
@@ -48,6 +50,94 @@ namespace build2
     }
   }
 
+  // Parse a regular expression caching the result.
+  //
+  // Buildfiles often apply the same pattern to many values (for example, in
+  // a for-loop) and compiling a regex is expensive. So we keep a bounded
+  // (least recently used entries are evicted) cache of compiled regexes
+  // keyed by the pattern and flags. Note that matching against the same
+  // std::regex object from multiple threads is safe.
+  //
+  // The maximum number of cached regexes with 0 meaning no caching. Should
+  // only be changed before any regex is parsed.
+  //
+  // Note: also used in unit-tests/function (thus not static).
+  //
+  size_t regex_cache_max = 256;
+
+  struct regex_cache_key
+  {
+    string pattern;
+    regex::flag_type flags;
+
+    bool
+    operator== (const regex_cache_key& x) const
+    {
+      return flags == x.flags && pattern == x.pattern;
+    }
+  };
+
+  struct regex_cache_hash
+  {
+    size_t
+    operator() (const regex_cache_key& k) const
+    {
+      return hash<string> () (k.pattern) ^ static_cast<size_t> (k.flags);
+    }
+  };
+
+  using regex_cache_list =
+    list<pair<regex_cache_key, shared_ptr<const regex>>>;
+
+  static regex_cache_list regex_cache_lru; // Most recently used first.
+  static unordered_map<regex_cache_key,
+                       regex_cache_list::iterator,
+                       regex_cache_hash> regex_cache;
+  static mutex regex_cache_mutex;
+
+  static shared_ptr<const regex>
+  parse_regex_cached (const string& s, regex::flag_type f)
+  {
+    if (regex_cache_max == 0)
+      return make_shared<const regex> (parse_regex (s, f));
+
+    regex_cache_key k {s, f};
+
+    {
+      mlock l (regex_cache_mutex);
+
+      auto i (regex_cache.find (k));
+      if (i != regex_cache.end ())
+      {
+        regex_cache_lru.splice (regex_cache_lru.begin (),
+                                regex_cache_lru,
+                                i->second);
+        return i->second->second;
+      }
+    }
+
+    // Compile without holding the lock. If another thread compiles the same
+    // regex in the meantime, then we will just use ours.
+    //
+    shared_ptr<const regex> r (make_shared<const regex> (parse_regex (s, f)));
+
+    mlock l (regex_cache_mutex);
+
+    if (regex_cache.find (k) == regex_cache.end ())
+    {
+      if (regex_cache.size () == regex_cache_max)
+      {
+        regex_cache.erase (regex_cache_lru.back ().first);
+        regex_cache_lru.pop_back ();
+      }
+
+      regex_cache_lru.emplace_front (k, r);
+      regex_cache.emplace (move (k), regex_cache_lru.begin ());
+    }
+
+    return r;
+  }
+
   // Match value of an arbitrary type against the regular expression. See
   // match() overloads (below) for details.
   //
@@ -76,7 +166,8 @@ namespace build2
 
     // Parse regex.
     //
-    regex rge (parse_regex (re, rf));
+    shared_ptr<const regex> pr (parse_regex_cached (re, rf));
+    const regex& rge (*pr);
 
     // Match.
     //
@@ -134,7 +225,8 @@ namespace build2
 
     // Parse regex.
     //
-    regex rge (parse_regex (re, rf));
+    shared_ptr<const regex> pr (parse_regex_cached (re, rf));
+    const regex& rge (*pr);
 
     // Search.
     //
@@ -205,7 +297,8 @@ namespace build2
            optional<names>&& flags)
   {
     auto fl (parse_replacement_flags (move (flags)));
-    regex rge (parse_regex (re, fl.first));
+    shared_ptr<const regex> pr (parse_regex_cached (re, fl.first));
+    const regex& rge (*pr);
 
     names r;
 
@@ -235,7 +328,8 @@ namespace build2
          optional<names>&& flags)
   {
     auto fl (parse_replacement_flags (move (flags), false));
-    regex rge (parse_regex (re, fl.first));
+    shared_ptr<const regex> pr (parse_regex_cached (re, fl.first));
+    const regex& rge (*pr);
 
     names r;
 
@@ -268,7 +362,8 @@ namespace build2
          optional<names>&& flags)
   {
     auto fl (parse_replacement_flags (move (flags)));
-    regex rge (parse_regex (re, fl.first));
+    shared_ptr<const regex> pr (parse_regex_cached (re, fl.first));
+    const regex& rge (*pr);
 
     names r;
 
@@ -305,7 +400,8 @@ namespace build2
          optional<names>&& flags)
   {
     auto fl (parse_replacement_flags (move (flags)));
-    regex rge (parse_regex (re, fl.first));
+    shared_ptr<const regex> pr (parse_regex_cached (re, fl.first));
+    const regex& rge (*pr);
 
     string rs;
 
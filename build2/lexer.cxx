@@ -91,9 +91,25 @@ namespace build2
     default: assert (false); // Unhandled custom mode.
     }
 
+    assert (word_separators (s1, ps));
     state_.push (state {m, ps, s, n, q, *esc, s1, s2});
   }
 
+  bool lexer::
+  word_separators (const char* s, char ps)
+  {
+    if (word_char (ps))
+      return false;
+
+    for (; s != nullptr && *s != '\0'; ++s)
+    {
+      if (word_char (*s))
+        return false;
+    }
+
+    return true;
+  }
+
   token lexer::
   next ()
   {
@@ -461,6 +477,16 @@ namespace build2
           }
         }
       }
+      // Word characters can be neither separators nor quotes so we can skip
+      // all the checks below for them (this covers the bulk of characters in
+      // a typical buildfile).
+      //
+      else if (word_char (c))
+      {
+        get ();
+        append (c);
+        continue;
+      }
       else
       {
         // First check if it's a pair separator.
@@ -136,10 +136,33 @@ namespace build2
       // sep_second. If there are multiple sequences that start with the same
       // character, then repeat the first character in sep_first.
       //
+      // Note that neither these nor the pair separator can be word
+      // characters (see word_char() below).
+      //
       const char* sep_first;
       const char* sep_second;
     };
 
+    // Return true if this is a word character, that is, an ASCII letter,
+    // digit, or one of the _./- characters. These are never special in any
+    // mode (other than the variable mode) which allows word() to scan them
+    // without any further checks.
+    //
+    static bool
+    word_char (char c)
+    {
+      return (c >= 'a' && c <= 'z') ||
+             (c >= 'A' && c <= 'Z') ||
+             (c >= '0' && c <= '9') ||
+             c == '_' || c == '.' || c == '/' || c == '-';
+    }
+
+    // Return true if none of the specified separators is a word character.
+    // Should be asserted for every mode pushed.
+    //
+    static bool
+    word_separators (const char* sep_first, char sep_pair);
+
     token
     next_eval ();
 
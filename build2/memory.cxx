@@ -0,0 +1,69 @@
+// file      : build2/memory.cxx -*- C++ -*-
+// copyright : Copyright (c) 2014-2019 Code Synthesis Ltd
+// license   : MIT; see accompanying LICENSE file
+
+#include <build2/memory.hxx>
+
+using namespace std;
+
+namespace build2
+{
+  static const char* const memory_subsystem_names[] =
+  {
+    "targets",
+    "prerequisites",
+    "variables",
+    "scopes",
+    "depdb",
+    "functions",
+    "parser"
+  };
+
+  const char*
+  to_string (memory_subsystem s)
+  {
+    return memory_subsystem_names[static_cast<size_t> (s)];
+  }
+
+  memory_counter
+  memory_counters[static_cast<size_t> (memory_subsystem::count_)];
+
+  bool memory_enabled_ = false;
+
+#ifdef __cpp_thread_local
+  thread_local
+#else
+  __thread
+#endif
+  memory_counter* memory_guard_counter_ = nullptr;
+
+  void
+  memory_enable ()
+  {
+    memory_enabled_ = true;
+  }
+
+  void
+  memory_allocate (memory_subsystem s, size_t n)
+  {
+    memory_counter& c (memory_counters[static_cast<size_t> (s)]);
+
+    c.allocations.fetch_add (1, memory_order_relaxed);
+    c.bytes.fetch_add (n, memory_order_relaxed);
+
+    uint64_t l (c.live.fetch_add (n, memory_order_relaxed) + n);
+
+    for (uint64_t p (c.peak.load (memory_order_relaxed)); p < l; )
+    {
+      if (c.peak.compare_exchange_weak (p, l, memory_order_relaxed))
+        break;
+    }
+  }
+
+  void
+  memory_deallocate (memory_subsystem s, size_t n)
+  {
+    memory_counters[static_cast<size_t> (s)].live.fetch_sub (
+      n, memory_order_relaxed);
+  }
+}
@@ -0,0 +1,147 @@
+// file      : build2/memory.hxx -*- C++ -*-
+// copyright : Copyright (c) 2014-2019 Code Synthesis Ltd
+// license   : MIT; see accompanying LICENSE file
+
+#ifndef BUILD2_MEMORY_HXX
+#define BUILD2_MEMORY_HXX
+
+#include <new> // operator new/delete
+
+#include <build2/types.hxx>
+#include <build2/utility.hxx>
+
+namespace build2
+{
+  // Memory usage accounting by subsystem (see --mem-stat).
+  //
+  // There are two ways the memory is attributed to a subsystem. Firstly, the
+  // main containers of the build state use counting_allocator which keeps
+  // track of the live and peak number of bytes they occupy. Secondly, the
+  // code that performs the subsystem's work (parsing, function calls, etc)
+  // establishes memory_guard for its duration and the heap allocations made
+  // by the calling thread in the meantime (as seen by the global operator
+  // new) are attributed to this subsystem. Note that the latter is inclusive
+  // (for example, a target allocated while parsing a buildfile is counted
+  // in both the targets and parser subsystems) and only the number and the
+  // total size of such allocations are known.
+  //
+  // If accounting is not enabled, then all of this amounts to testing a
+  // flag.
+  //
+  enum class memory_subsystem: uint8_t
+  {
+    targets,
+    prerequisites,
+    variables,
+    scopes,
+    depdb,
+    functions,
+    parser,
+    count_ // Number of subsystems.
+  };
+
+  const char*
+  to_string (memory_subsystem);
+
+  struct memory_counter
+  {
+    atomic<uint64_t> live        {0};
+    atomic<uint64_t> peak        {0};
+    atomic<uint64_t> allocations {0};
+    atomic<uint64_t> bytes       {0};
+  };
+
+  extern memory_counter
+  memory_counters[static_cast<size_t> (memory_subsystem::count_)];
+
+  // Enable accounting. Should be called before the build state is created
+  // since deallocations are only counted if enabled.
+  //
+  void
+  memory_enable ();
+
+  inline bool
+  memory_enabled ();
+
+  // Container memory accounting.
+  //
+  void
+  memory_allocate (memory_subsystem, size_t);
+
+  void
+  memory_deallocate (memory_subsystem, size_t);
+
+  template <typename T, memory_subsystem S>
+  struct counting_allocator
+  {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {using other = counting_allocator<U, S>;};
+
+    counting_allocator () = default;
+
+    template <typename U>
+    counting_allocator (const counting_allocator<U, S>&) noexcept {}
+
+    T*
+    allocate (size_t n)
+    {
+      n *= sizeof (T);
+
+      if (memory_enabled ())
+        memory_allocate (S, n);
+
+      return static_cast<T*> (::operator new (n));
+    }
+
+    void
+    deallocate (T* p, size_t n) noexcept
+    {
+      if (memory_enabled ())
+        memory_deallocate (S, n * sizeof (T));
+
+      ::operator delete (p);
+    }
+  };
+
+  template <typename T, typename U, memory_subsystem S>
+  inline bool
+  operator== (const counting_allocator<T, S>&, const counting_allocator<U, S>&)
+  {
+    return true;
+  }
+
+  template <typename T, typename U, memory_subsystem S>
+  inline bool
+  operator!= (const counting_allocator<T, S>&, const counting_allocator<U, S>&)
+  {
+    return false;
+  }
+
+  // Attribute the heap allocations made by this thread to the subsystem for
+  // the duration of the guard. Guards can be nested with the innermost one
+  // taking precedence.
+  //
+  struct memory_guard
+  {
+    explicit
+    memory_guard (memory_subsystem);
+
+    ~memory_guard ();
+
+    memory_guard (const memory_guard&) = delete;
+    memory_guard& operator= (const memory_guard&) = delete;
+
+    memory_counter* prev;
+  };
+
+  // Called by the global operator new for each allocation.
+  //
+  inline void
+  memory_attribute (size_t);
+}
+
+#include <build2/memory.ixx>
+
+#endif // BUILD2_MEMORY_HXX
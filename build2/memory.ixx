@@ -0,0 +1,46 @@
+// file      : build2/memory.ixx -*- C++ -*-
+// copyright : Copyright (c) 2014-2019 Code Synthesis Ltd
+// license   : MIT; see accompanying LICENSE file
+
+namespace build2
+{
+  extern bool memory_enabled_;
+
+  extern
+#ifdef __cpp_thread_local
+  thread_local
+#else
+  __thread
+#endif
+  memory_counter* memory_guard_counter_;
+
+  inline bool
+  memory_enabled ()
+  {
+    return memory_enabled_;
+  }
+
+  inline memory_guard::
+  memory_guard (memory_subsystem s)
+      : prev (memory_guard_counter_)
+  {
+    if (memory_enabled_)
+      memory_guard_counter_ = &memory_counters[static_cast<size_t> (s)];
+  }
+
+  inline memory_guard::
+  ~memory_guard ()
+  {
+    memory_guard_counter_ = prev;
+  }
+
+  inline void
+  memory_attribute (size_t n)
+  {
+    if (memory_counter* c = memory_guard_counter_)
+    {
+      c->allocations.fetch_add (1, memory_order_relaxed);
+      c->bytes.fetch_add (n, memory_order_relaxed);
+    }
+  }
+}
@@ -133,6 +133,11 @@ namespace build2
     {
       phase_lock l (run_phase::match);
 
+      // Size the scheduler's wait queue based on the number of targets
+      // loaded so far (see scheduler::tune_wait_queue() for details).
+      //
+      sched.tune_wait_queue (targets.size ());
+
       // Setup progress reporting if requested.
       //
       string what; // Note: must outlive monitor_guard.
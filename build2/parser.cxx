@@ -14,6 +14,7 @@
 #include <build2/scope.hxx>
 #include <build2/module.hxx>
 #include <build2/target.hxx>
+#include <build2/memory.hxx>
 #include <build2/context.hxx>
 #include <build2/function.hxx>
 #include <build2/variable.hxx>
@@ -245,6 +246,8 @@ namespace build2
   void parser::
   parse_buildfile (istream& is, const path& p, scope& root, scope& base)
   {
+    memory_guard mg (memory_subsystem::parser);
+
     path_ = &p;
 
     lexer l (is, *path_);
@@ -273,6 +276,8 @@ namespace build2
   token parser::
   parse_variable (lexer& l, scope& s, const variable& var, type kind)
   {
+    memory_guard mg (memory_subsystem::parser);
+
     path_ = &l.name ();
     lexer_ = &l;
     scope_ = &s;
@@ -292,6 +297,8 @@ namespace build2
                         const dir_path* b,
                         const variable& var)
   {
+    memory_guard mg (memory_subsystem::parser);
+
     path_ = &l.name ();
     lexer_ = &l;
     scope_ = &s;
@@ -1292,6 +1299,21 @@ namespace build2
 
       l6 ([&]{trace (l) << "absolute path " << p;});
 
+      // In the load on demand mode we defer loading of subdirectory
+      // buildfiles until a target in their scope is searched for (see
+      // load_deferred() for details).
+      //
+      if (load_on_demand && scope_ != ocs && p.leaf () == buildfile_file)
+      {
+        if (defer_buildfile (*root_, *scope_, p))
+          l5 ([&]{trace (l) << "deferring " << p;});
+
+        pbase_ = opb;
+        scope_ = ocs;
+        root_ = ors;
+        continue;
+      }
+
       if (!root_->buildfiles.insert (p).second) // Note: may be "new" root.
       {
         l5 ([&]{trace (l) << "skipping already included " << p;});
@@ -0,0 +1,50 @@
+// file      : build2/path-pool.cxx -*- C++ -*-
+// copyright : Copyright (c) 2014-2019 Code Synthesis Ltd
+// license   : MIT; see accompanying LICENSE file
+
+#include <build2/path-pool.hxx>
+
+using namespace std;
+
+namespace build2
+{
+  dir_path_pool dir_path_interns;
+
+  dir_path_pool::
+  dir_path_pool ()
+      : empty_ (&*set_.insert (dir_path ()).first)
+  {
+  }
+
+  const dir_path& dir_path_pool::
+  insert (dir_path d)
+  {
+    if (d.empty ())
+      return *empty_;
+
+    {
+      slock l (mutex_);
+
+      auto i (set_.find (d));
+      if (i != set_.end ())
+        return *i;
+    }
+
+    ulock l (mutex_);
+    return *set_.insert (move (d)).first;
+  }
+
+  size_t dir_path_pool::
+  size () const
+  {
+    slock l (mutex_);
+    return set_.size ();
+  }
+
+  void dir_path_pool::
+  clear ()
+  {
+    set_.clear ();
+    empty_ = &*set_.insert (dir_path ()).first;
+  }
+}
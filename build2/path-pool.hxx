@@ -0,0 +1,59 @@
+// file      : build2/path-pool.hxx -*- C++ -*-
+// copyright : Copyright (c) 2014-2019 Code Synthesis Ltd
+// license   : MIT; see accompanying LICENSE file
+
+#ifndef BUILD2_PATH_POOL_HXX
+#define BUILD2_PATH_POOL_HXX
+
+#include <unordered_set>
+
+#include <build2/types.hxx>
+#include <build2/utility.hxx>
+
+namespace build2
+{
+  // Pool of interned directory paths.
+  //
+  // Target and prerequisite directories are interned in this pool so that
+  // each directory is only stored once regardless of the number of targets
+  // and prerequisites that refer to it. Because an interned path has a
+  // stable address that uniquely identifies it, it can also be compared by
+  // address (see target_set).
+  //
+  // The pool is part of the build state and is cleared together with the
+  // target set (see target_set::clear()).
+  //
+  class dir_path_pool
+  {
+  public:
+    // Return the interned path, inserting it if necessary. Thread-safe.
+    //
+    const dir_path&
+    insert (dir_path);
+
+    // Number of interned paths.
+    //
+    size_t
+    size () const;
+
+    // Not MT-safe so can only be used during serial execution.
+    //
+    void
+    clear ();
+
+    dir_path_pool ();
+
+  private:
+    mutable shared_mutex mutex_;
+    std::unordered_set<dir_path> set_;
+
+    // Interned empty path (which is the out directory of most targets) that
+    // we look up without locking.
+    //
+    const dir_path* empty_;
+  };
+
+  extern dir_path_pool dir_path_interns;
+}
+
+#endif // BUILD2_PATH_POOL_HXX
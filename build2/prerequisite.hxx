@@ -9,7 +9,9 @@
 #include <build2/utility.hxx>
 
 #include <build2/action.hxx>
+#include <build2/memory.hxx>
 #include <build2/variable.hxx>
+#include <build2/path-pool.hxx>
 #include <build2/target-key.hxx>
 #include <build2/diagnostics.hxx>
 
@@ -63,10 +65,12 @@ namespace build2
     // bar/ here is relative to the scope, not to foo/. Plus, bar/ can resolve
     // to either src or out.
     //
+    // Note that the directories are interned (see dir_path_pool).
+    //
     const optional<project_name> proj;
     const target_type_type& type;
-    const dir_path dir;         // Normalized absolute or relative (to scope).
-    const dir_path out;         // Empty, normalized absolute, or relative.
+    const dir_path& dir;        // Normalized absolute or relative (to scope).
+    const dir_path& out;        // Empty, normalized absolute, or relative.
     const string name;
     const optional<string> ext; // Absent if unspecified.
     const scope_type& scope;
@@ -110,8 +114,8 @@ namespace build2
                   const scope_type& s)
         : proj (move (p)),
           type (t),
-          dir (move (d)),
-          out (move (o)),
+          dir (dir_path_interns.insert (move (d))),
+          out (dir_path_interns.insert (move (o))),
           name (move (n)),
           ext (move (e)),
           scope (s),
@@ -155,8 +159,8 @@ namespace build2
     prerequisite (prerequisite&& x)
         : proj (move (x.proj)),
           type (x.type),
-          dir (move (x.dir)),
-          out (move (x.out)),
+          dir (x.dir),
+          out (x.out),
           name (move (x.name)),
           ext (move (x.ext)),
           scope (x.scope),
@@ -181,7 +185,9 @@ namespace build2
     return os << p.key ();
   }
 
-  using prerequisites = vector<prerequisite>;
+  using prerequisites =
+    vector<prerequisite,
+           counting_allocator<prerequisite, memory_subsystem::prerequisites>>;
 
   // Helpers for dealing with the prerequisite inclusion/exclusion (the
   // 'include' buildfile variable, see var_include in context.hxx).
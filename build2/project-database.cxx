@@ -0,0 +1,86 @@
+// file      : build2/project-database.cxx -*- C++ -*-
+// copyright : Copyright (c) 2014-2019 Code Synthesis Ltd
+// license   : MIT; see accompanying LICENSE file
+
+#include <build2/project-database.hxx>
+
+#include <map>
+
+#include <build2/scope.hxx>
+#include <build2/context.hxx>
+#include <build2/filesystem.hxx>
+
+using namespace std;
+using namespace butl;
+
+namespace build2
+{
+  // All the databases in this build keyed by their file and then by their
+  // out_root.
+  //
+  static std::map<const path*,
+                  std::map<dir_path, unique_ptr<project_database>>> databases;
+  static shared_mutex databases_mutex;
+
+  project_database& project_database::
+  instance (const scope& rs, const path& f, factory c)
+  {
+    const dir_path& d (rs.out_path ());
+
+    {
+      slock l (databases_mutex);
+
+      auto i (databases.find (&f));
+      if (i != databases.end ())
+      {
+        auto j (i->second.find (d));
+        if (j != i->second.end ())
+          return *j->second;
+      }
+    }
+
+    ulock l (databases_mutex);
+
+    auto& m (databases[&f]);
+
+    auto j (m.find (d));
+    if (j != m.end ())
+      return *j->second;
+
+    // Register the write callback with the first database.
+    //
+    static bool registered (false);
+    if (!registered)
+    {
+      operation_end_callbacks.push_back (&write_all);
+      registered = true;
+    }
+
+    return *m.emplace (
+      d, c (d, d != rs.src_path () ? d / f : path ())).first->second;
+  }
+
+  bool project_database::
+  loadable () const
+  {
+    return !path_.empty () && file_exists (path_);
+  }
+
+  bool project_database::
+  writable () const
+  {
+    return !path_.empty () && exists (path_.directory ());
+  }
+
+  void project_database::
+  write_all (action)
+  {
+    ulock l (databases_mutex);
+
+    for (auto& p: databases)
+    {
+      for (auto& q: p.second)
+        q.second->write_changed ();
+    }
+  }
+}
@@ -0,0 +1,98 @@
+// file      : build2/project-database.hxx -*- C++ -*-
+// copyright : Copyright (c) 2014-2019 Code Synthesis Ltd
+// license   : MIT; see accompanying LICENSE file
+
+#ifndef BUILD2_PROJECT_DATABASE_HXX
+#define BUILD2_PROJECT_DATABASE_HXX
+
+#include <build2/types.hxx>
+#include <build2/utility.hxx>
+
+#include <build2/action.hxx>
+
+namespace build2
+{
+  class scope;
+
+  // Per-project database stored in out_root/build/ (see durations and
+  // test::history for examples).
+  //
+  // There is a single instance of each database (identified by its file)
+  // for each project. It is created (and normally loaded) on first access
+  // and written at the end of each operation batch. The databases are not
+  // part of the build state and so are not affected by reset().
+  //
+  // For in source builds out_root/build/ is part of the project's source so
+  // the databases are not stored there (but are still used within the same
+  // build). For out of source builds their files are removed on disfigure
+  // (see config/operation.cxx).
+  //
+  class project_database
+  {
+  public:
+    // Return the database of type T stored in the specified file (relative
+    // to out_root) for the project with the specified root scope, creating
+    // it if necessary. The file should have static storage duration (it is
+    // used to identify the database). T should derive from this class, be
+    // constructible from (dir_path out_root, path file) where file is empty
+    // if the database is not stored, and befriend this class. Thread-safe.
+    //
+    template <typename T>
+    static T&
+    instance (const scope& root, const path& file);
+
+    virtual
+    ~project_database () = default;
+
+  protected:
+    project_database (dir_path out_root, path file)
+        : out_root_ (move (out_root)), path_ (move (file)) {}
+
+    // Return true if the database file should be read.
+    //
+    bool
+    loadable () const;
+
+    // Return true if the database file should be written. Note that the
+    // build/ subdirectory may not exist in out_root if the project hasn't
+    // been configured.
+    //
+    bool
+    writable () const;
+
+    // Write the database if anything has changed. Called serially at the
+    // end of the operation batch.
+    //
+    virtual void
+    write_changed () = 0;
+
+  protected:
+    const dir_path out_root_;
+    const path path_; // Absolute or empty if not stored.
+
+  private:
+    using factory = unique_ptr<project_database> (*) (dir_path, path);
+
+    static project_database&
+    instance (const scope&, const path&, factory);
+
+    static void
+    write_all (action);
+  };
+
+  template <typename T>
+  inline T& project_database::
+  instance (const scope& rs, const path& f)
+  {
+    return static_cast<T&> (
+      instance (rs,
+                f,
+                [] (dir_path d, path p) -> unique_ptr<project_database>
+                {
+                  return unique_ptr<project_database> (
+                    new T (move (d), move (p)));
+                }));
+  }
+}
+
+#endif // BUILD2_PROJECT_DATABASE_HXX
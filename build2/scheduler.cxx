@@ -201,12 +201,50 @@ namespace build2
     activate ();
   }
 
+  void scheduler::
+  acquire (resource_pool& p)
+  {
+    if (p.limit == 0)
+      return;
+
+    lock l (p.mutex);
+
+    if (p.used == p.limit)
+    {
+      // Don't hold the pool lock while (de)activating since that grabs the
+      // scheduler lock.
+      //
+      l.unlock ();
+      deactivate ();
+      l.lock ();
+
+      while (p.used == p.limit)
+        p.condv.wait (l);
+
+      p.used++;
+      l.unlock ();
+
+      activate ();
+    }
+    else
+      p.used++;
+  }
+
+  void scheduler::
+  release (resource_pool& p)
+  {
+    if (p.limit == 0)
+      return;
+
+    lock l (p.mutex);
+    p.used--;
+    p.condv.notify_one ();
+  }
+
   size_t scheduler::
   suspend (size_t start_count, const atomic_count& task_count)
   {
-    wait_slot& s (
-      wait_queue_[
-        hash<const atomic_count*> () (&task_count) % wait_queue_size_]);
+    wait_slot& s (wait_slot_for (task_count));
 
     // This thread is no longer active.
     //
@@ -218,21 +256,27 @@ namespace build2
     // and the wait.
     //
     size_t tc (0);
-    bool collision;
+    bool collision (false);
     {
+      wait_slot::waiter w;
+      w.task_count = &task_count;
+
       lock l (s.mutex);
 
       // We have a collision if there is already a waiter for a different
       // task count.
       //
-      collision = (s.waiters++ != 0 && s.task_count != &task_count);
+      for (const wait_slot::waiter* p (s.waiters); p != nullptr; p = p->next)
+      {
+        if (p->task_count != &task_count)
+        {
+          collision = true;
+          break;
+        }
+      }
 
-      // This is nuanced: we want to always have the task count of the last
-      // thread to join the queue. Otherwise, if threads are leaving and
-      // joining the queue simultaneously, we may end up with a task count of
-      // a thread group that is no longer waiting.
-      //
-      s.task_count = &task_count;
+      w.next = s.waiters;
+      s.waiters = &w;
 
       // We could probably relax the atomic access since we use a mutex for
       // synchronization though this has a different tradeoff (calling wait
@@ -240,11 +284,20 @@ namespace build2
       //
       while (!(s.shutdown ||
                (tc = task_count.load (memory_order_acquire)) <= start_count))
-        s.condv.wait (l);
+        w.condv.wait (l);
 
-      s.waiters--;
+      // Unlink ourselves. Note that the list is short (bounded by the number
+      // of threads and normally just a few entries).
+      //
+      wait_slot::waiter** p (&s.waiters);
+      for (; *p != &w; p = &(*p)->next) ;
+      *p = w.next;
     }
 
+    wait_stat_.suspends++;
+    wait_stat_.task_count = &task_count;
+    wait_stat_.collision = collision;
+
     // This thread is no longer waiting.
     //
     activate (collision);
@@ -258,15 +311,34 @@ namespace build2
     if (max_active_ == 1) // Serial execution, nobody to wakeup.
       return;
 
-    wait_slot& s (
-      wait_queue_[hash<const atomic_count*> () (&tc) % wait_queue_size_]);
+    wait_slot& s (wait_slot_for (tc));
 
     // See suspend() for why we must hold the lock.
     //
     lock l (s.mutex);
 
-    if (s.waiters != 0)
-      s.condv.notify_all ();
+    // Only wake up the threads waiting on this task count.
+    //
+    for (wait_slot::waiter* p (s.waiters); p != nullptr; p = p->next)
+    {
+      if (p->task_count == &tc)
+        p->condv.notify_one ();
+    }
+  }
+
+  auto scheduler::
+  wait_slot_for (const atomic_count& tc) -> wait_slot&
+  {
+    // Task counts are normally members of targets which are allocated from
+    // an arena in fixed-size chunks. As a result, their addresses have
+    // poorly distributed lower bits so we mix them before picking the slot.
+    //
+    uint64_t h (reinterpret_cast<uintptr_t> (&tc));
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+
+    return wait_queue_[static_cast<size_t> (h % wait_queue_size_)];
   }
 
   scheduler::
@@ -420,6 +492,36 @@ namespace build2
     max_active_ = max_active;
   }
 
+  void scheduler::
+  tune_wait_queue (size_t n)
+  {
+    if (max_threads_ == 1) // Serial execution, no wait queue.
+      return;
+
+    // The number of distinct task counts that can be waited on at the same
+    // time is bounded by the number of threads so there is no use going
+    // above a few times that. But there is also no use going much above the
+    // number of objects that can be waited on.
+    //
+    n = max (shard_size (), min (n, max_threads_ * 8));
+
+    lock l (wait_idle ());
+
+    if (n == wait_queue_size_)
+      return;
+
+    // There are no suspended threads so nobody should be holding on to the
+    // slots.
+    //
+    unique_ptr<wait_slot[]> q (new wait_slot[n]);
+
+    for (size_t i (0); i != n; ++i)
+      q[i].shutdown = false;
+
+    wait_queue_ = move (q);
+    wait_queue_size_ = n;
+  }
+
   auto scheduler::
   shutdown () -> stat
   {
@@ -472,8 +574,16 @@ namespace build2
           ready_condv_.notify_all ();
 
         if (w)
+        {
           for (size_t i (0); i != wait_queue_size_; ++i)
-            wait_queue_[i].condv.notify_all ();
+          {
+            wait_slot& ws (wait_queue_[i]);
+            lock l (ws.mutex);
+
+            for (wait_slot::waiter* p (ws.waiters); p != nullptr; p = p->next)
+              p->condv.notify_one ();
+          }
+        }
 
         this_thread::yield ();
         l.lock ();
@@ -776,6 +886,13 @@ namespace build2
 #endif
   scheduler::task_queue* scheduler::task_queue_ = nullptr;
 
+#ifdef __cpp_thread_local
+    thread_local
+#else
+    __thread
+#endif
+  scheduler::wait_stat scheduler::wait_stat_ = {0, nullptr, false};
+
   auto scheduler::
   create_queue () -> task_queue&
   {
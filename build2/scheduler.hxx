@@ -129,6 +129,23 @@ namespace build2
     void
     resume (const atomic_count& task_count);
 
+    // Information about the calling thread's suspensions in wait(): the
+    // total number of times it had to suspend and, for the last suspension,
+    // the task count it waited on and whether its wait slot was shared with
+    // threads waiting on a different task count. Can be used to attribute
+    // the suspensions to the objects being waited on (see algorithm.cxx for
+    // an example).
+    //
+    struct wait_stat
+    {
+      size_t suspends;
+      const atomic_count* task_count;
+      bool collision;
+    };
+
+    static wait_stat
+    thread_wait_stat () {return wait_stat_;}
+
     // An active thread that is about to wait for potentially significant time
     // on something other than task_count (e.g., mutex, condition variable)
     // should deactivate itself with the scheduler and then reactivate once
@@ -147,6 +164,60 @@ namespace build2
     void
     sleep (const duration&);
 
+    // Resource pools.
+    //
+    // A resource pool limits the number of tasks of a certain cost class
+    // (for example, memory-heavy links) that can hold its slot concurrently.
+    // This limit is independent of (and in addition to) max_active. A thread
+    // that has to wait for a slot deactivates itself so that tasks of other
+    // classes (for example, compilations) continue to run at full width.
+    //
+    // Note that the limit can only be changed while the scheduler is
+    // inactive (see tune() for details). Zero limit means unlimited.
+    //
+    struct resource_pool
+    {
+      explicit
+      resource_pool (size_t l = 0): limit (l) {}
+
+      size_t limit;
+
+      std::mutex mutex;
+      std::condition_variable condv;
+      size_t used = 0;
+    };
+
+    void
+    acquire (resource_pool&);
+
+    void
+    release (resource_pool&);
+
+    // Acquire a slot (if the pool is not NULL) and release it on destruction.
+    //
+    struct resource_guard
+    {
+      resource_guard (scheduler& s, resource_pool* p)
+          : s_ (s), p_ (p)
+      {
+        if (p_ != nullptr)
+          s_.acquire (*p_);
+      }
+
+      ~resource_guard ()
+      {
+        if (p_ != nullptr)
+          s_.release (*p_);
+      }
+
+      resource_guard (const resource_guard&) = delete;
+      resource_guard& operator= (const resource_guard&) = delete;
+
+    private:
+      scheduler& s_;
+      resource_pool* p_;
+    };
+
     // Startup and shutdown.
     //
   public:
@@ -207,6 +278,14 @@ namespace build2
     void
     tune (size_t max_active);
 
+    // Resize the wait queue of a started up scheduler based on the number
+    // of objects that may be waited on (for example, the number of targets
+    // in the build graph). The size is kept within the limits derived from
+    // max_threads. The same restrictions as for tune() apply.
+    //
+    void
+    tune_wait_queue (size_t objects);
+
     // Return true if the scheduler is configured to run tasks serially.
     //
     // Note: can only be called from threads that have observed startup.
@@ -448,24 +527,48 @@ namespace build2
     //
     // The wait queue is a shard of slots. A thread picks a slot based on the
     // address of its task count variable. How many slots do we need? This
-    // depends on the number of waiters that we can have which cannot be
-    // greater than the total number of threads.
-    //
-    // The pointer to the task count is used to identify the already waiting
-    // group of threads for collision statistics.
+    // depends on the number of distinct task counts being waited on which
+    // cannot be greater than the total number of threads. But since we pick
+    // the slot by hashing, we want a few times that to keep the collisions
+    // rare (see tune_wait_queue()).
+    //
+    // Each waiting thread has its own condition variable and is linked into
+    // the slot's list of waiters together with the task count it is waiting
+    // on. This way resuming a task count only wakes up threads waiting on
+    // this task count even if they share the slot with others. A thread
+    // joining a slot that has waiters for a different task count is counted
+    // as a collision for statistics.
     //
     struct wait_slot
     {
+      struct waiter
+      {
+        const atomic_count* task_count;
+        std::condition_variable condv;
+        waiter* next;
+      };
+
       std::mutex mutex;
-      std::condition_variable condv;
-      size_t waiters = 0;
-      const atomic_count* task_count;
+      waiter* waiters = nullptr; // Allocated on the waiting thread's stack.
       bool shutdown = true;
     };
 
     size_t wait_queue_size_; // Proportional to max_threads.
     unique_ptr<wait_slot[]> wait_queue_;
 
+    wait_slot&
+    wait_slot_for (const atomic_count&);
+
+    // TLS wait statistics (see thread_wait_stat()).
+    //
+    static
+#ifdef __cpp_thread_local
+    thread_local
+#else
+    __thread
+#endif
+    wait_stat wait_stat_;
+
     // Task queue.
     //
     // Each queue has its own mutex plus we have an atomic total count of the
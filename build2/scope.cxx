@@ -11,6 +11,137 @@ using namespace std;
 
 namespace build2
 {
+  // scope_lookup_cache
+  //
+  auto scope_lookup_cache::
+  find (const variable& var) const -> const entry*
+  {
+    const table* t (table_.load (memory_order_acquire));
+
+    if (t != nullptr)
+    {
+      // Note that the table is never full.
+      //
+      for (size_t i (var.id & t->mask);; i = (i + 1) & t->mask)
+      {
+        const entry& e (t->entries[i]);
+        const variable* v (e.var.load (memory_order_acquire));
+
+        if (v == &var)
+          return e.generation.load (memory_order_acquire) == lookup_generation
+            ? &e
+            : nullptr;
+
+        if (v == nullptr)
+          break;
+      }
+    }
+
+    return nullptr;
+  }
+
+  auto scope_lookup_cache::
+  insert (const variable& var, const lookup& l, size_t d, bool tv)
+    -> const entry&
+  {
+    // Return the entry for the variable or an unused one.
+    //
+    auto slot = [] (table& t, const variable& v) -> entry&
+    {
+      for (size_t i (v.id & t.mask);; i = (i + 1) & t.mask)
+      {
+        entry& e (t.entries[i]);
+        const variable* ev (e.var.load (memory_order_relaxed));
+
+        if (ev == &v || ev == nullptr)
+          return e;
+      }
+    };
+
+    // Fill the entry making sure the generation is published last.
+    //
+    auto fill = [] (table& t, entry& e,
+                    const variable& v,
+                    const lookup& l, size_t d, bool tv)
+    {
+      if (e.var.load (memory_order_relaxed) == nullptr)
+      {
+        e.var.store (&v, memory_order_release);
+        t.size++;
+      }
+
+      e.value = l;
+      e.depth = d;
+      e.target = tv;
+      e.generation.store (lookup_generation, memory_order_release);
+    };
+
+    mlock ml (mutex_);
+
+    table* t (tables_.empty () ? nullptr : tables_.back ().get ());
+
+    // Grow the table if it is about to become more than half full carrying
+    // over the still valid entries.
+    //
+    if (t == nullptr || (t->size + 1) * 2 > t->mask + 1)
+    {
+      size_t n (t != nullptr ? (t->mask + 1) * 2 : 16);
+
+      unique_ptr<table> nt (
+        new table {n - 1, 0, unique_ptr<entry[]> (new entry[n])});
+
+      if (t != nullptr)
+      {
+        for (size_t i (0); i <= t->mask; ++i)
+        {
+          const entry& e (t->entries[i]);
+
+          if (const variable* v = e.var.load (memory_order_relaxed))
+          {
+            if (e.generation.load (memory_order_relaxed) == lookup_generation)
+              fill (*nt, slot (*nt, *v), *v, e.value, e.depth, e.target);
+          }
+        }
+      }
+
+      tables_.push_back (move (nt));
+      t = tables_.back ().get ();
+      table_.store (t, memory_order_release);
+    }
+
+    entry& e (slot (*t, var));
+
+    // Someone else could have beaten us to it.
+    //
+    if (e.var.load (memory_order_relaxed) != &var ||
+        e.generation.load (memory_order_relaxed) != lookup_generation)
+      fill (*t, e, var, l, d, tv);
+
+    return e;
+  }
+
+  // Return the scope in which to continue looking up a variable according to
+  // its visibility or NULL if there is none.
+  //
+  static inline const scope*
+  outer_scope (const scope& s, const variable& var)
+  {
+    switch (var.visibility)
+    {
+    case variable_visibility::scope:
+      return nullptr;
+    case variable_visibility::target:
+    case variable_visibility::project:
+      return s.root () ? nullptr : s.parent_scope ();
+    case variable_visibility::normal:
+      return s.parent_scope ();
+    case variable_visibility::prereq:
+      assert (false);
+    }
+
+    return nullptr;
+  }
+
   // scope
   //
   pair<lookup, size_t> scope::
@@ -26,6 +157,56 @@ namespace build2
     if (var.visibility == variable_visibility::prereq)
       return make_pair (lookup (), d);
 
+    // Use the lookup cache if possible. We only cache the lookup of the
+    // scope variable (in this and outer scopes) but note whether there are
+    // any target type/pattern-specific values for this variable along the
+    // way. If there are none, then we can use the cached value for a target
+    // lookup as well.
+    //
+    if (start_d == 1                                  &&
+        var.visibility != variable_visibility::target &&
+        phase != run_phase::load                      &&
+        lookup_cache.enabled ())
+    {
+      const scope_lookup_cache::entry* e (lookup_cache.find (var));
+
+      if (e == nullptr)
+      {
+        lookup l;
+        bool tv (false);
+
+        for (const scope* s (this); s != nullptr; s = outer_scope (*s, var))
+        {
+          ++d;
+
+          if (!tv && !s->target_vars.empty ())
+            tv = s->target_vars.contains (var);
+
+          auto p (s->vars.find (var));
+          if (p.first != nullptr)
+          {
+            l = lookup (*p.first, p.second, s->vars);
+            break;
+          }
+        }
+
+        e = &lookup_cache.insert (
+          var, l, l.defined () ? d : size_t (~0), tv);
+      }
+
+      if (tt == nullptr)
+        return make_pair (e->value, e->depth);
+
+      // For a target each scope is three lookups deep (target, group, and
+      // scope variables).
+      //
+      if (!e->target)
+        return make_pair (e->value,
+                          e->value.defined () ? e->depth * 3 : size_t (~0));
+
+      d = 0;
+    }
+
     // Process target type/pattern-specific prepend/append values.
     //
     auto pre_app = [&var] (lookup& l,
@@ -49,7 +230,7 @@ namespace build2
 
       // Check the cache.
       //
-      pair<value&, ulock> entry (
+      pair<value&, variable_cache_lock> entry (
         s->target_vars.cache.insert (
           make_tuple (&v, tt, *tn),
           stem,
@@ -155,21 +336,7 @@ namespace build2
           return make_pair (lookup (*p.first, p.second, s->vars), d);
       }
 
-      switch (var.visibility)
-      {
-      case variable_visibility::scope:
-        s = nullptr;
-        break;
-      case variable_visibility::target:
-      case variable_visibility::project:
-        s = s->root () ? nullptr : s->parent_scope ();
-        break;
-      case variable_visibility::normal:
-        s = s->parent_scope ();
-        break;
-      case variable_visibility::prereq:
-        assert (false);
-      }
+      s = outer_scope (*s, var);
     }
 
     return make_pair (lookup (), size_t (~0));
@@ -424,7 +591,7 @@ namespace build2
 
     // Check the cache.
     //
-    pair<value&, ulock> entry (
+    pair<value&, variable_cache_lock> entry (
       inner_proj->override_cache.insert (
         make_pair (&var, inner_vars),
         stem,
@@ -813,6 +980,12 @@ namespace build2
     //
     if (er.second)
     {
+      // The map is not allocator-aware so account for the entry ourselves
+      // (see reset() for the other half).
+      //
+      if (memory_enabled ())
+        memory_allocate (memory_subsystem::scopes, sizeof (value_type));
+
       scope* p (nullptr);
 
       // Update scopes of which we are a new parent/root (unless this is the
@@ -25,6 +25,69 @@ namespace build2
 {
   class dir;
 
+  // Scope variable lookup cache.
+  //
+  // Caches the results of looking up variables starting from a scope (see
+  // scope::find_original() for details). Since the build state can only be
+  // changed during the load phase, the cache is only used during the match
+  // and execute phases and all its entries are invalidated on each switch
+  // to load (see lookup_generation).
+  //
+  // The cache is an open-addressing hash table keyed by the variable id.
+  // Hits are lock-free while fills are serialized by the mutex. Because
+  // readers may still be using the table being replaced as a result of
+  // growth, retired tables are only released together with the cache.
+  //
+  class scope_lookup_cache
+  {
+  public:
+    struct entry
+    {
+      atomic<const variable*> var {nullptr}; // NULL if unused.
+      atomic<size_t> generation {0};         // Valid if current.
+
+      lookup value;  // Scope variable lookup result.
+      size_t depth;  // Scope variable lookup depth.
+      bool   target; // Target type/pattern-specific values along the way.
+    };
+
+    // Return NULL if there is no entry or it is stale.
+    //
+    const entry*
+    find (const variable&) const;
+
+    const entry&
+    insert (const variable&, const lookup&, size_t depth, bool target);
+
+    bool
+    enabled () const {return enabled_;}
+
+    explicit
+    scope_lookup_cache (bool enabled): enabled_ (enabled) {}
+
+    // Only an empty cache can be moved (see scope_map::insert()).
+    //
+    scope_lookup_cache (scope_lookup_cache&& c)
+        : enabled_ (c.enabled_)
+    {
+      assert (c.tables_.empty ());
+    }
+
+  private:
+    struct table
+    {
+      size_t mask; // Capacity - 1.
+      size_t size; // Used entries.
+      unique_ptr<entry[]> entries;
+    };
+
+    bool enabled_;
+    atomic<const table*> table_ {nullptr};
+
+    mutex mutex_;
+    vector<unique_ptr<table>> tables_; // Retired followed by current.
+  };
+
   class scope
   {
   public:
@@ -195,6 +258,10 @@ namespace build2
     variable_cache<pair<const variable*, const variable_map*>>
     override_cache;
 
+    // Scope variable lookup cache (global scopes only).
+    //
+    mutable scope_lookup_cache lookup_cache;
+
     // Meta/operations supported by this project (set on the root
     // scope only).
     //
@@ -210,6 +277,12 @@ namespace build2
     //
     std::unordered_set<path_type> buildfiles;
 
+    // Buildfile for this scope whose loading was deferred until a target in
+    // this scope is searched for (see defer_buildfile() for details). Empty
+    // if there is none.
+    //
+    path_type deferred_buildfile;
+
     // Target types.
     //
   public:
@@ -308,7 +381,8 @@ namespace build2
     friend scope& create_bootstrap_inner (scope&, const dir_path&);
 
     explicit
-    scope (bool global): vars (global), target_vars (global) {}
+    scope (bool global)
+        : vars (global), target_vars (global), lookup_cache (global) {}
 
     scope* parent_;
     scope* root_;
@@ -33,17 +33,12 @@ namespace build2
     bool is_a (const target_type& tt) const {return type->is_a (tt);}
   };
 
+  // Compare the extensions of two keys of the same target type. Unless
+  // fixed, unspecified and specified extensions are assumed equal.
+  //
   inline bool
-  operator== (const target_key& x, const target_key& y)
+  equal_ext (const target_key& x, const target_key& y)
   {
-    if (x.type  != y.type ||
-        *x.dir  != *y.dir ||
-        *x.out  != *y.out ||
-        *x.name != *y.name)
-      return false;
-
-    // Unless fixed, unspecified and specified extensions are assumed equal.
-    //
     const target_type& tt (*x.type);
 
     if (tt.fixed_extension == nullptr)
@@ -57,6 +52,18 @@ namespace build2
     }
   }
 
+  inline bool
+  operator== (const target_key& x, const target_key& y)
+  {
+    if (x.type  != y.type ||
+        *x.dir  != *y.dir ||
+        *x.out  != *y.out ||
+        *x.name != *y.name)
+      return false;
+
+    return equal_ext (x, y);
+  }
+
   inline bool
   operator!= (const target_key& x, const target_key& y) {return !(x == y);}
 
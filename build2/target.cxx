@@ -292,10 +292,94 @@ namespace build2
     }
   }
 
+  // Target arena.
+  //
+  // Targets are bump-allocated from large blocks which reduces the per-
+  // allocation overhead and keeps targets created together (for example,
+  // from the same buildfile) close in memory. Allocation is serialized but
+  // it is cheap compared to the rest of target creation.
+  //
+  static const size_t arena_block_size = 1024 * 1024;
+  static const size_t arena_align = alignof (std::max_align_t);
+
+  static mutex arena_mutex;
+  static vector<unique_ptr<char[]>> arena_blocks;
+  static char* arena_next = nullptr;
+  static size_t arena_left = 0;
+  static size_t arena_used = 0;
+  static size_t arena_size = 0; // Total size of the blocks.
+
+  static char*
+  arena_block (size_t n)
+  {
+    arena_blocks.push_back (unique_ptr<char[]> (new char[n]));
+    arena_size += n;
+
+    if (memory_enabled ())
+      memory_allocate (memory_subsystem::targets, n);
+
+    return arena_blocks.back ().get ();
+  }
+
+  void* target::
+  operator new (size_t n)
+  {
+    n = (n + arena_align - 1) & ~(arena_align - 1);
+
+    mlock l (arena_mutex);
+
+    if (n > arena_left)
+    {
+      // Allocate large targets (not something we expect to see) in a
+      // dedicated block so that we don't waste the rest of the current
+      // block.
+      //
+      if (n > arena_block_size / 4)
+      {
+        arena_used += n;
+        return arena_block (n);
+      }
+
+      arena_next = arena_block (arena_block_size);
+      arena_left = arena_block_size;
+    }
+
+    void* r (arena_next);
+    arena_next += n;
+    arena_left -= n;
+    arena_used += n;
+    return r;
+  }
+
   // target_set
   //
   target_set targets;
 
+  void target_set::
+  clear ()
+  {
+    map_.clear ();
+    dir_path_interns.clear ();
+
+    mlock l (arena_mutex);
+
+    if (memory_enabled ())
+      memory_deallocate (memory_subsystem::targets, arena_size);
+
+    arena_blocks.clear ();
+    arena_next = nullptr;
+    arena_left = 0;
+    arena_used = 0;
+    arena_size = 0;
+  }
+
+  size_t target_set::
+  memory ()
+  {
+    mlock l (arena_mutex);
+    return arena_used;
+  }
+
   const target* target_set::
   find (const target_key& k, tracer& trace) const
   {
@@ -17,6 +17,7 @@
 #include <build2/scope.hxx>
 #include <build2/action.hxx>
 #include <build2/variable.hxx>
+#include <build2/path-pool.hxx>
 #include <build2/target-key.hxx>
 #include <build2/target-type.hxx>
 #include <build2/target-state.hxx>
@@ -106,7 +107,11 @@ namespace build2
     bool               adhoc;  // True if include=adhoc.
     uintptr_t          data;
   };
-  using prerequisite_targets = vector<prerequisite_target>;
+
+  // Most targets have only a handful of prerequisites so we keep them in the
+  // inline storage to avoid a dynamic allocation for each target/action.
+  //
+  using prerequisite_targets = small_vector<prerequisite_target, 8>;
 
   // A rule match is an element of hint_rule_map.
   //
@@ -133,8 +138,10 @@ namespace build2
     // when src == out). We also treat out of project targets as being in the
     // out tree.
     //
-    const dir_path   dir;  // Absolute and normalized.
-    const dir_path   out;  // Empty or absolute and normalized.
+    // Note that the directories are interned (see dir_path_pool).
+    //
+    const dir_path&  dir;  // Absolute and normalized.
+    const dir_path&  out;  // Empty or absolute and normalized.
     const string     name;
 
     const string* ext () const; // Return NULL if not specified.
@@ -472,7 +479,15 @@ namespace build2
       // detect the last chance (i.e., last dependent) to execute the command
       // (see also the first/last execution modes in <operation.hxx>).
       //
-      mutable atomic_count dependents {0};
+      // Note that it is 32-bit so that together with the state below it
+      // occupies a single word.
+      //
+      mutable atomic<uint32_t> dependents {0};
+
+      // Target state for this operation. Note that it is undetermined until
+      // a rule is matched and recipe applied (see set_recipe()).
+      //
+      target_state state;
 
       // Matched rule (pointer to hint_rule_map element). Note that in case of
       // a direct recipe assignment we may not have a rule (NULL).
@@ -483,11 +498,6 @@ namespace build2
       //
       build2::recipe recipe;
 
-      // Target state for this operation. Note that it is undetermined until
-      // a rule is matched and recipe applied (see set_recipe()).
-      //
-      target_state state;
-
       // Rule-specific variables.
       //
       // The rule (for this action) has to be matched before these variables
@@ -749,9 +759,22 @@ namespace build2
 
     // Targets should be created via the targets set below.
     //
+    // Note also that targets are allocated from an arena which is only
+    // released when the target set is cleared (see target_set::clear()).
+    // In particular, the memory of a target that is destroyed individually
+    // is not reclaimed until then.
+    //
   public:
+    static void*
+    operator new (size_t);
+
+    static void
+    operator delete (void*) noexcept {}
+
     target (dir_path d, dir_path o, string n)
-        : dir (move (d)), out (move (o)), name (move (n)),
+        : dir (dir_path_interns.insert (move (d))),
+          out (dir_path_interns.insert (move (o))),
+          name (move (n)),
           vars (false /* global */) {}
 
     target (target&&) = delete;
@@ -1298,8 +1321,32 @@ namespace build2
   //
   class target_set
   {
+    // The keys in the map always point to the interned directories (see
+    // dir_path_pool). The lookup keys built from targets and prerequisites
+    // normally do too, in which case the directories compare by address.
+    // Otherwise we fall back to comparing them by value.
+    //
+    struct key_equal
+    {
+      bool
+      operator() (const target_key& x, const target_key& y) const
+      {
+        return x.type  == y.type                      &&
+               (x.dir  == y.dir || *x.dir == *y.dir)  &&
+               (x.out  == y.out || *x.out == *y.out)  &&
+               *x.name == *y.name                     &&
+               equal_ext (x, y);
+      }
+    };
+
   public:
-    using map_type = std::unordered_map<target_key, unique_ptr<target>>;
+    using map_type = std::unordered_map<
+      target_key,
+      unique_ptr<target>,
+      std::hash<target_key>,
+      key_equal,
+      counting_allocator<pair<const target_key, unique_ptr<target>>,
+                         memory_subsystem::targets>>;
 
     // Return existing target or NULL.
     //
@@ -1431,8 +1478,20 @@ namespace build2
     iterator begin () const {return map_.begin ();}
     iterator end ()   const {return map_.end ();}
 
+    size_t
+    size () const {return map_.size ();}
+
+    // Destroy all the targets and release the arena from which they were
+    // allocated.
+    //
     void
-    clear () {map_.clear ();}
+    clear ();
+
+    // Number of bytes currently allocated from the target arena, including
+    // the targets that are no longer in the set.
+    //
+    static size_t
+    memory ();
 
   private:
     friend class target; // Access to mutex.
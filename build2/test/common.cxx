@@ -216,5 +216,24 @@ namespace build2
 
       return r;
     }
+
+    bool common::
+    shard (const string& k) const
+    {
+      if (shard_count == 0)
+        return true;
+
+      // FNV-1a. Note that we cannot use std::hash since the result must be
+      // the same across runs (and platforms) for shards to be disjoint.
+      //
+      uint64_t h (0xcbf29ce484222325ULL);
+      for (char c: k)
+      {
+        h ^= static_cast<unsigned char> (c);
+        h *= 0x100000001b3ULL;
+      }
+
+      return h % shard_count == shard_index - 1;
+    }
   }
 }
@@ -21,6 +21,9 @@ namespace build2
     {
       const variable& config_test;
       const variable& config_test_output;
+      const variable& config_test_shard;
+      const variable& config_test_retry;
+      const variable& config_test_timeout;
 
       const variable& var_test;
       const variable& test_options;
@@ -41,6 +44,20 @@ namespace build2
       output_before before = output_before::warn;
       output_after after = output_after::clean;
 
+      // The config.test.shard values (1-based index and count; 0 if not
+      // sharding) and the config.test.retry value.
+      //
+      uint64_t shard_index = 0;
+      uint64_t shard_count = 0;
+
+      uint64_t retry = 0;
+
+      // The config.test.timeout values: the testscript scope (test or group)
+      // and the command timeouts.
+      //
+      optional<duration> scope_timeout;
+      optional<duration> command_timeout;
+
       // The config.test query interface.
       //
       const names* test_ = nullptr; // The config.test value if any.
@@ -63,6 +80,12 @@ namespace build2
       bool
       test (const target& test_target, const path& id_path) const;
 
+      // Return true if the test with the specified history key belongs to
+      // this shard (see config.test.shard).
+      //
+      bool
+      shard (const string& key) const;
+
       explicit
       common (common_data&& d): common_data (move (d)) {}
     };
@@ -0,0 +1,199 @@
+// file      : build2/test/history.cxx -*- C++ -*-
+// copyright : Copyright (c) 2014-2019 Code Synthesis Ltd
+// license   : MIT; see accompanying LICENSE file
+
+#include <build2/test/history.hxx>
+
+#include <build2/file.hxx>
+#include <build2/scope.hxx>
+#include <build2/target.hxx>
+#include <build2/filesystem.hxx>
+#include <build2/diagnostics.hxx>
+
+using namespace std;
+using namespace butl;
+
+namespace build2
+{
+  namespace test
+  {
+    history& history::
+    instance (const target& t)
+    {
+      return project_database::instance<history> (t.root_scope (),
+                                                  test_history_file);
+    }
+
+    string history::
+    key (const target& t, const path& id)
+    {
+      string r (t.type ().name);
+      r += '{';
+      r += t.out_dir ().leaf (t.root_scope ().out_path ()).representation ();
+      r += t.name;
+      r += '}';
+
+      if (!id.empty ())
+      {
+        r += '#';
+        r += id.string ();
+      }
+
+      return r;
+    }
+
+    history::
+    history (dir_path d, path f)
+        : project_database (move (d), move (f))
+    {
+      load ();
+    }
+
+    auto history::
+    find (const string& k) const -> const entry*
+    {
+      auto i (previous_.find (k));
+      return i != previous_.end () ? &i->second : nullptr;
+    }
+
+    void history::
+    insert (string k,
+            duration d,
+            bool f,
+            uint64_t n,
+            duration cpu,
+            uint64_t rss)
+    {
+      using namespace chrono;
+
+      entry e {
+        static_cast<uint64_t> (duration_cast<microseconds> (d).count ()),
+        static_cast<uint64_t> (duration_cast<microseconds> (cpu).count ()),
+        rss,
+        f,
+        n};
+
+      mlock l (mutex_);
+      current_[move (k)] = e;
+    }
+
+    bool history::
+    before (const entry* x, const entry* y)
+    {
+      if (x == nullptr || y == nullptr)
+        return x != nullptr;
+
+      if (x->failed != y->failed)
+        return x->failed;
+
+      return x->duration > y->duration;
+    }
+
+    void history::
+    load ()
+    {
+      if (!loadable ())
+        return;
+
+      try
+      {
+        ifdstream is (path_, ifdstream::badbit);
+
+        for (string l; !eof (getline (is, l)); )
+        {
+          // <microseconds> <cpu-microseconds> <max-rss-kb> <status> <reruns>
+          // <key>
+          //
+          size_t p[5];
+          size_t n (0);
+          for (size_t b (0); n != 5; b = p[n++] + 1)
+          {
+            if ((p[n] = l.find (' ', b)) == string::npos)
+              break;
+          }
+
+          if (n != 5 || p[4] + 1 == l.size ())
+            continue; // Skip invalid lines.
+
+          auto field = [&l, &p] (size_t i)
+          {
+            size_t b (i == 0 ? 0 : p[i - 1] + 1);
+            return string (l, b, p[i] - b);
+          };
+
+          string s (field (3));
+
+          if (s != "passed" && s != "failed")
+            continue;
+
+          entry e;
+          try
+          {
+            e.duration = stoull (field (0));
+            e.cpu_time = stoull (field (1));
+            e.max_rss = stoull (field (2));
+            e.reruns = stoull (field (4));
+          }
+          catch (const invalid_argument&) {continue;}
+          catch (const out_of_range&) {continue;}
+
+          e.failed = (s == "failed");
+
+          previous_[string (l, p[4] + 1)] = e;
+        }
+
+        is.close ();
+      }
+      catch (const io_error& e)
+      {
+        warn << "unable to read test history " << path_ << ": " << e;
+      }
+    }
+
+    void history::
+    write_changed ()
+    {
+      mlock l (mutex_);
+
+      if (current_.empty ())
+        return;
+
+      for (auto& p: current_)
+        previous_[p.first] = p.second;
+
+      current_.clear ();
+
+      if (!writable ())
+        return;
+
+      if (verb >= 3)
+        text << "cat >" << path_;
+
+      try
+      {
+        ofdstream os (path_);
+
+        for (const auto& p: previous_)
+        {
+          const entry& e (p.second);
+
+          os << e.duration << ' '
+             << e.cpu_time << ' '
+             << e.max_rss << ' '
+             << (e.failed ? "failed" : "passed") << ' '
+             << e.reruns << ' '
+             << p.first << '\n';
+        }
+
+        os.close ();
+      }
+      catch (const io_error& e)
+      {
+        // Not fatal: we will just run the tests in the declaration order
+        // next time.
+        //
+        warn << "unable to write test history " << path_ << ": " << e;
+      }
+    }
+  }
+}
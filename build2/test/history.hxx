@@ -0,0 +1,115 @@
+// file      : build2/test/history.hxx -*- C++ -*-
+// copyright : Copyright (c) 2014-2019 Code Synthesis Ltd
+// license   : MIT; see accompanying LICENSE file
+
+#ifndef BUILD2_TEST_HISTORY_HXX
+#define BUILD2_TEST_HISTORY_HXX
+
+#include <unordered_map>
+
+#include <build2/types.hxx>
+#include <build2/utility.hxx>
+
+#include <build2/project-database.hxx>
+
+namespace build2
+{
+  class target;
+
+  namespace test
+  {
+    // Test results database.
+    //
+    // Records the outcome and duration of the simple tests, testscripts, and
+    // testscript scopes (groups and tests) that were run. On the next run
+    // this information is used to start the previously failed tests first
+    // followed by the longest ones, which reduces the time to the first
+    // failure as well as the tail of the test run.
+    //
+    // The database for each project is stored in out_root/build/test-history,
+    // one entry per line in the following form:
+    //
+    // <microseconds> <cpu-microseconds> <max-rss-kb> <status> <reruns> <key>
+    //
+    // Where status is either 'passed' or 'failed' and reruns is the number of
+    // times the test had to be rerun before it passed (see config.test.retry;
+    // non-zero means the test is flaky). The CPU time and the maximum
+    // resident set size are those of the test processes executed by a
+    // testscript scope, including its nested scopes (0 if unknown). Key is the
+    // test target (in the <type>{<dir>/<name>} form with directory relative to
+    // out_root) optionally followed by '#' and the testscript id path. It is
+    // written at the end of the operation batch but only if anything has
+    // changed (see project_database for details).
+    //
+    class history: public project_database
+    {
+    public:
+      struct entry
+      {
+        uint64_t duration; // Microseconds.
+        uint64_t cpu_time; // Microseconds.
+        uint64_t max_rss;  // Kilobytes.
+        bool failed;
+        uint64_t reruns;
+      };
+
+      // Return the database for the project of the specified test target,
+      // loading it if necessary. Thread-safe.
+      //
+      static history&
+      instance (const target&);
+
+      // Return the key for the specified test target and testscript id path.
+      //
+      static string
+      key (const target&, const path& id_path = path ());
+
+      // Return the entry recorded by a previous run or NULL if there is
+      // none. Thread-safe.
+      //
+      const entry*
+      find (const string& key) const;
+
+      // Record the entry for this run. Thread-safe.
+      //
+      void
+      insert (string key,
+              duration,
+              bool failed,
+              uint64_t reruns = 0,
+              duration cpu_time = duration::zero (),
+              uint64_t max_rss = 0);
+
+      // Return true if, based on their history, the test with the first
+      // entry should be started before the test with the second. Either can
+      // be NULL (no history) in which case the test is started after those
+      // with history.
+      //
+      static bool
+      before (const entry*, const entry*);
+
+    private:
+      friend class project_database;
+
+      history (dir_path out_root, path file);
+
+      void
+      load ();
+
+      virtual void
+      write_changed () override;
+
+    private:
+      // The previous entries are loaded during construction and are not
+      // modified until the end of the operation (so can be looked up without
+      // locking). The current ones are merged into them once written.
+      //
+      std::unordered_map<string, entry> previous_;
+
+      mutex mutex_;
+      std::unordered_map<string, entry> current_;
+    };
+  }
+}
+
+#endif // BUILD2_TEST_HISTORY_HXX
@@ -56,6 +56,28 @@ namespace build2
         //
         vp.insert<name_pair> ("config.test.output", true),
 
+        // Run only the subset of tests in the specified shard. The value has
+        // the <index>/<count> form with index starting from 1 (for example,
+        // 2/4 for the second of four shards). Tests are distributed between
+        // shards based on the hash of the test target name and, for
+        // testscripts, the testscript name so the same test always ends up in
+        // the same shard.
+        //
+        vp.insert<string> ("config.test.shard", true),
+
+        // Rerun a failed testscript up to the specified number of times and
+        // report it as flaky rather than failed if one of the reruns passes.
+        //
+        vp.insert<uint64_t> ("config.test.retry", true),
+
+        // Testscript timeouts in seconds specified in the
+        // [<scope>][/<command>] form. The scope timeout limits the execution
+        // of each test and group (including nested scopes) and the command
+        // timeout -- of each test command. A process that runs past the
+        // timeout is killed and the test fails.
+        //
+        vp.insert<string> ("config.test.timeout", true),
+
         // The test variable is a name which can be a path (with the
         // true/false special values) or a target name.
         //
@@ -192,6 +214,97 @@ namespace build2
         else fail << "invalid config.test.output before value '" << b << "'";
       }
 
+      // config.test.shard
+      //
+      if (lookup l = config::omitted (rs, m.config_test_shard).first)
+      {
+        const string& v (cast<string> (l));
+
+        size_t p (v.find ('/'));
+
+        try
+        {
+          if (p != string::npos)
+          {
+            string i (v, 0, p), c (v, p + 1);
+
+            // Note that stoull() would have accepted leading spaces and
+            // sign.
+            //
+            auto digits = [] (const string& s)
+            {
+              return !s.empty () &&
+                s.find_first_not_of ("0123456789") == string::npos;
+            };
+
+            if (digits (i) && digits (c))
+            {
+              m.shard_index = stoull (i);
+              m.shard_count = stoull (c);
+            }
+          }
+        }
+        catch (const invalid_argument&) {}
+        catch (const out_of_range&) {}
+
+        if (m.shard_count == 0             ||
+            m.shard_index == 0             ||
+            m.shard_index > m.shard_count)
+          fail << "invalid config.test.shard value '" << v << "'" <<
+            info << "expected <index>/<count> with index in the [1, count] "
+               << "range";
+      }
+
+      // config.test.retry
+      //
+      if (lookup l = config::omitted (rs, m.config_test_retry).first)
+        m.retry = cast<uint64_t> (l);
+
+      // config.test.timeout
+      //
+      if (lookup l = config::omitted (rs, m.config_test_timeout).first)
+      {
+        const string& v (cast<string> (l));
+
+        auto parse = [&v] (const string& s) -> optional<duration>
+        {
+          if (s.empty ())
+            return nullopt;
+
+          uint64_t n (0);
+
+          if (s.find_first_not_of ("0123456789") == string::npos)
+          {
+            try
+            {
+              n = stoull (s);
+            }
+            catch (const out_of_range&) {}
+          }
+
+          if (n == 0)
+            fail << "invalid config.test.timeout value '" << v << "'" <<
+              info << "expected [<scope>][/<command>] timeouts in seconds";
+
+          return duration (chrono::seconds (n));
+        };
+
+        size_t p (v.find ('/'));
+
+        m.scope_timeout = parse (string (v, 0, p));
+
+        if (p != string::npos)
+          m.command_timeout = parse (string (v, p + 1));
+
+#ifdef _WIN32
+        // @@ TODO: see wait_process() in script/runner.cxx.
+        //
+        if (m.scope_timeout || m.command_timeout)
+          warn << "config.test.timeout is not supported on this platform, "
+               << "ignoring";
+#endif
+      }
+
       //@@ TODO: Need ability to specify extra diff options (e.g.,
       //   --strip-trailing-cr, now hardcoded).
       //
@@ -11,6 +11,7 @@
 #include <build2/diagnostics.hxx>
 
 #include <build2/test/target.hxx>
+#include <build2/test/history.hxx>
 
 #include <build2/test/script/parser.hxx>
 #include <build2/test/script/runner.hxx>
@@ -287,6 +288,12 @@ namespace build2
             if (!test)
               test = t[test_options] || t[test_arguments];
           }
+
+          // Testscripts are distributed between shards individually (see
+          // perform_script()).
+          //
+          if (test)
+            test = shard (history::key (t));
         }
       }
 
@@ -348,6 +355,17 @@ namespace build2
       return ts;
     }
 
+    // Return the history key of the testscript. Note that the id must match
+    // the script id path (see script::script()), which is empty for the
+    // testscript file regardless of how many testscripts there are.
+    //
+    static inline string
+    history_key (const target& t, const testscript& ts)
+    {
+      return history::key (t,
+                           ts.name == "testscript" ? path () : path (ts.name));
+    }
+
     static script::scope_state
     perform_script_impl (const target& t,
                          const testscript& ts,
@@ -358,32 +376,77 @@ namespace build2
 
       scope_state r;
 
-      try
+      // Rerun the failed testscript up to config.test.retry times. Note that
+      // while a testscript is just as likely to be flaky as a simple test,
+      // here we can rerun it in a clean working directory (we cleanup what a
+      // failed run left behind before each rerun).
+      //
+      for (uint64_t n (0);; ++n)
       {
-        if (verb)
+        timestamp st (system_clock::now ());
+        dir_path swd;
+
+        duration cpu (duration::zero ());
+        uint64_t rss (0);
+
+        try
         {
-          diag_record dr (text);
-          dr << "test " << ts;
+          if (verb)
+          {
+            diag_record dr (text);
+            dr << "test " << ts;
+
+            if (!t.is_a<alias> ())
+              dr << ' ' << t;
+          }
+
+          build2::test::script::script s (t, ts, wd);
+          swd = s.wd_path;
+
+          {
+            parser p;
+            p.pre_parse (s);
 
-          if (!t.is_a<alias> ())
-            dr << ' ' << t;
+            default_runner r (c);
+            p.execute (s, r);
+          }
+
+          r = s.state;
+          cpu = s.cpu_time;
+          rss = s.max_rss;
         }
+        catch (const failed&)
+        {
+          r = scope_state::failed;
+        }
+
+        bool f (r == scope_state::failed);
 
-        build2::test::script::script s (t, ts, wd);
+        history::instance (t).insert (
+          history_key (t, ts),
+          system_clock::now () - st,
+          f,
+          n,
+          cpu,
+          rss);
 
+        if (!f)
         {
-          parser p;
-          p.pre_parse (s);
+          if (n != 0)
+            warn << "test " << ts << " of target " << t << " is flaky" <<
+              info << "passed after " << n << " rerun(s)";
 
-          default_runner r (c);
-          p.execute (s, r);
+          break;
         }
 
-        r = s.state;
-      }
-      catch (const failed&)
-      {
-        r = scope_state::failed;
+        if (n == c.retry || swd.empty ())
+          break;
+
+        warn << "rerunning test " << ts << " of target " << t
+             << " (" << n + 1 << '/' << c.retry << ')';
+
+        if (exists (swd))
+          build2::rmdir_r (swd, true, 2);
       }
 
       return r;
@@ -501,6 +564,15 @@ namespace build2
       vector<scope_state> result;
       result.reserve (pts_n - pass_n); // Make sure there are no reallocations.
 
+      // Select the testscripts to run (those that are not ignored via
+      // config.test and belong to our config.test.shard) and start them in
+      // the history order (previously failed first, then the longest).
+      //
+      const history& h (history::instance (t));
+
+      vector<pair<const history::entry*, const testscript*>> tss;
+      tss.reserve (pts_n - pass_n);
+
       for (size_t i (pass_n); i != pts_n; ++i)
       {
         const testscript& ts (*pts[i]->is_a<testscript> ());
@@ -509,40 +581,59 @@ namespace build2
         // can only be ignored by ignoring the test target, which makes sense
         // since it's the only testscript file).
         //
-        if (one || test (t, path (ts.name)))
+        path id (one ? path () : path (ts.name));
+
+        if (one || test (t, id))
         {
-          if (mk)
-          {
-            mkdir_buildignore (wd, 2);
-            mk = false;
-          }
+          string k (history_key (t, ts));
 
-          result.push_back (scope_state::unknown);
-          scope_state& r (result.back ());
-
-          if (!sched.async (target::count_busy (),
-                            t[a].task_count,
-                            [this] (const diag_frame* ds,
-                                    scope_state& r,
-                                    const target& t,
-                                    const testscript& ts,
-                                    const dir_path& wd)
-                            {
-                              diag_frame::stack_guard dsg (ds);
-                              r = perform_script_impl (t, ts, wd, *this);
-                            },
-                            diag_frame::stack,
-                            ref (r),
-                            cref (t),
-                            cref (ts),
-                            cref (wd)))
-          {
-            // Executed synchronously. If failed and we were not asked to keep
-            // going, bail out.
-            //
-            if (r == scope_state::failed && !keep_going)
-              break;
-          }
+          if (shard (k))
+            tss.emplace_back (h.find (k), &ts);
+        }
+      }
+
+      stable_sort (tss.begin (), tss.end (),
+                   [] (const pair<const history::entry*, const testscript*>& x,
+                       const pair<const history::entry*, const testscript*>& y)
+                   {
+                     return history::before (x.first, y.first);
+                   });
+
+      for (const auto& p: tss)
+      {
+        const testscript& ts (*p.second);
+
+        if (mk)
+        {
+          mkdir_buildignore (wd, 2);
+          mk = false;
+        }
+
+        result.push_back (scope_state::unknown);
+        scope_state& r (result.back ());
+
+        if (!sched.async (target::count_busy (),
+                          t[a].task_count,
+                          [this] (const diag_frame* ds,
+                                  scope_state& r,
+                                  const target& t,
+                                  const testscript& ts,
+                                  const dir_path& wd)
+                          {
+                            diag_frame::stack_guard dsg (ds);
+                            r = perform_script_impl (t, ts, wd, *this);
+                          },
+                          diag_frame::stack,
+                          ref (r),
+                          cref (t),
+                          cref (ts),
+                          cref (wd)))
+        {
+          // Executed synchronously. If failed and we were not asked to keep
+          // going, bail out.
+          //
+          if (r == scope_state::failed && !keep_going)
+            break;
         }
       }
 
@@ -828,11 +919,21 @@ namespace build2
       else if (verb)
         text << "test " << tt;
 
+      // Note that we don't rerun failed simple tests (config.test.retry)
+      // since their stdin may not be replayable.
+      //
+      timestamp st (system_clock::now ());
+
       diag_record dr;
-      if (!run_test (tt,
-                     dr,
-                     args.data () + (sin ? 3 : 0), // Skip cat.
-                     sin ? &cat : nullptr))
+      bool r (run_test (tt,
+                        dr,
+                        args.data () + (sin ? 3 : 0), // Skip cat.
+                        sin ? &cat : nullptr));
+
+      history::instance (tt).insert (
+        history::key (tt), system_clock::now () - st, !r);
+
+      if (!r)
       {
         dr << info << "test command line: ";
         print_process (dr, args);
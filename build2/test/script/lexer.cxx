@@ -136,6 +136,7 @@ namespace build2
         }
 
         assert (ps == '\0');
+        assert (word_separators (s1, ps));
         state_.push (state {m, ps, s, n, q, *esc, s1, s2});
       }
 
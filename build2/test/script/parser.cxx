@@ -4,8 +4,12 @@
 
 #include <build2/test/script/parser.hxx>
 
+#include <map>
 #include <sstream>
 
+#include <libbutl/sha256.mxx>
+#include <libbutl/filesystem.mxx> // file_mtime()
+
 #include <build2/context.hxx> // sched, keep_going
 
 #include <build2/test/script/lexer.hxx>
@@ -34,23 +38,189 @@ namespace build2
       // Pre-parse.
       //
 
+      // Pre-parse cache.
+      //
+      // The pre-parse result does not depend on the target being tested
+      // (unless a directive refers to variables; see pre_parse_lookup_) so
+      // when the same testscript is used to test multiple targets, we only
+      // pre-parse it once and give each script a copy of the result (we have
+      // to copy since the execution consumes it). Entries are keyed by the
+      // testscript path and are only reused if the testscript content
+      // checksum as well as the modification times of the included
+      // testscripts match.
+      //
+      // Note that the cached scripts own the testscript paths that the
+      // copies refer to and so are never destroyed: the replaced ones are
+      // retired instead. This also allows us to copy a cached script without
+      // holding the lock. Note also that the cache is not part of the build
+      // state and is reused across operations.
+      //
+      struct pre_parse_entry
+      {
+        string checksum;
+        vector<pair<path, timestamp>> includes;
+        unique_ptr<script> result;
+      };
+
+      static std::map<path, pre_parse_entry> pre_parse_cache;
+      static vector<unique_ptr<script>> pre_parse_retired;
+      static mutex pre_parse_cache_mutex;
+
       void parser::
       pre_parse (script& s)
       {
         const path& p (s.script_target.path ());
         assert (!p.empty ()); // Should have been assigned.
 
+        string c;
         try
         {
           ifdstream ifs (p);
-          pre_parse (ifs, s);
+          c.assign (istreambuf_iterator<char> (ifs),
+                    istreambuf_iterator<char> ());
+          ifs.close ();
         }
         catch (const io_error& e)
         {
-          fail << "unable to read testscript " << p << ": " << e << endf;
+          fail << "unable to read testscript " << p << ": " << e;
+        }
+
+        string cs (butl::sha256 (c).string ());
+
+        const script* cached (nullptr);
+        {
+          mlock l (pre_parse_cache_mutex);
+
+          auto i (pre_parse_cache.find (p));
+          if (i != pre_parse_cache.end () && i->second.checksum == cs)
+          {
+            const pre_parse_entry& e (i->second);
+
+            cached = e.result.get ();
+            for (const pair<path, timestamp>& ip: e.includes)
+            {
+              if (butl::file_mtime (ip.first) != ip.second)
+              {
+                cached = nullptr;
+                break;
+              }
+            }
+          }
+        }
+
+        if (cached != nullptr)
+        {
+          copy_pre_parse (*cached, s, s);
+          return;
+        }
+
+        istringstream is (c);
+        pre_parse (is, s);
+
+        if (pre_parse_lookup_)
+          return;
+
+        // Save a copy of the result in the cache moving the testscript paths
+        // (which are referred to by the pre-parse data) over to the cached
+        // script. Note that moving a set does not invalidate pointers to its
+        // elements.
+        //
+        pre_parse_entry e;
+        e.checksum = move (cs);
+
+        for (const path& ip: s.paths_)
+        {
+          if (ip != p)
+            e.includes.emplace_back (ip, butl::file_mtime (ip));
+        }
+
+        e.result.reset (
+          new script (s.test_target,
+                      s.script_target,
+                      s.id_path.empty () ? s.wd_path : s.wd_path.directory ()));
+
+        copy_pre_parse (s, *e.result, *e.result);
+        e.result->paths_ = move (s.paths_);
+
+        mlock l (pre_parse_cache_mutex);
+
+        pre_parse_entry& ce (pre_parse_cache[p]);
+
+        if (ce.result != nullptr)
+          pre_parse_retired.push_back (move (ce.result));
+
+        ce = move (e);
+      }
+
+      void parser::
+      copy_pre_parse (const scope& src, scope& dst, script& s)
+      {
+        dst.desc = src.desc;
+        dst.start_loc_ = src.start_loc_;
+        dst.end_loc_ = src.end_loc_;
+
+        if (src.if_cond_)
+          dst.if_cond_ = copy_pre_parse (*src.if_cond_, s);
+
+        if (const group* sg = dynamic_cast<const group*> (&src))
+        {
+          group& dg (dynamic_cast<group&> (dst));
+
+          for (const line& l: sg->setup_)
+            dg.setup_.push_back (copy_pre_parse (l, s));
+
+          for (const line& l: sg->tdown_)
+            dg.tdown_.push_back (copy_pre_parse (l, s));
+
+          for (const unique_ptr<scope>& c: sg->scopes)
+            dg.scopes.push_back (clone_pre_parse (*c, dg, s));
+        }
+        else
+        {
+          const test& st (dynamic_cast<const test&> (src));
+          test& dt (dynamic_cast<test&> (dst));
+
+          for (const line& l: st.tests_)
+            dt.tests_.push_back (copy_pre_parse (l, s));
         }
       }
 
+      unique_ptr<scope> parser::
+      clone_pre_parse (const scope& src, group& p, script& s)
+      {
+        // Note that the if-else chain elements have the same id and parent
+        // (see pre_parse_if_else_scope()).
+        //
+        string id (src.id_path.leaf ().string ());
+
+        unique_ptr<scope> r;
+        if (dynamic_cast<const group*> (&src) != nullptr)
+          r.reset (new group (id, p));
+        else
+          r.reset (new test (id, p));
+
+        copy_pre_parse (src, *r, s);
+
+        if (src.if_chain != nullptr)
+          r->if_chain = clone_pre_parse (*src.if_chain, p, s);
+
+        return r;
+      }
+
+      line parser::
+      copy_pre_parse (const line& l, script& s)
+      {
+        line r (l);
+
+        // Re-enter the variable into the target script's pool (see
+        // pre_parse_line()).
+        //
+        if (r.type == line_type::var)
+          r.var = &s.var_pool.insert (l.var->name);
+
+        return r;
+      }
+
       void parser::
       pre_parse (istream& is, script& s)
       {
@@ -62,6 +232,7 @@ namespace build2
         set_lexer (&l);
 
         id_prefix_.clear ();
+        pre_parse_lookup_ = false;
 
         id_map idm;
         include_set ins;
@@ -2852,6 +3023,8 @@ namespace build2
       static void
       execute_impl (scope& s, script& scr, runner& r)
       {
+        timestamp st (system_clock::now ());
+
         try
         {
           parser p;
@@ -2861,6 +3034,8 @@ namespace build2
         {
           s.state = scope_state::failed;
         }
+
+        r.complete (s, system_clock::now () - st);
       }
 
       void parser::
@@ -2883,12 +3058,12 @@ namespace build2
 
           if (exec_scope)
           {
-            atomic_count task_count (0);
-            wait_guard wg (task_count);
-
-            // Start asynchronous execution of inner scopes keeping track of
-            // how many we have handled.
+            // First select the inner scopes to execute (evaluating the
+            // if-else chains) and then start them in the order suggested by
+            // the runner (for example, previously failed first).
             //
+            vector<scope*> ss;
+
             for (unique_ptr<scope>& chain: g->scopes)
             {
               // Check if this scope is ignored (e.g., via config.test).
@@ -2986,42 +3161,53 @@ namespace build2
                            : ps->release ());
 
               if (chain != nullptr)
-              {
-                // Hand it off to a sub-parser potentially in another thread.
-                // But we could also have handled it serially in this parser:
-                //
-                // scope* os (scope_);
-                // scope_ = chain.get ();
-                // exec_scope_body ();
-                // scope_ = os;
+                ss.push_back (chain.get ());
+            }
 
-                // Pass our diagnostics stack (this is safe since we are going
-                // to wait for completion before unwinding the diag stack).
-                //
-                // If the scope was executed synchronously, check the status
-                // and bail out if we weren't asked to keep going.
+            runner_->order (ss);
+
+            // Start asynchronous execution of inner scopes keeping track of
+            // how many we have handled.
+            //
+            atomic_count task_count (0);
+            wait_guard wg (task_count);
+
+            for (scope* s: ss)
+            {
+              // Hand it off to a sub-parser potentially in another thread.
+              // But we could also have handled it serially in this parser:
+              //
+              // scope* os (scope_);
+              // scope_ = s;
+              // exec_scope_body ();
+              // scope_ = os;
+
+              // Pass our diagnostics stack (this is safe since we are going
+              // to wait for completion before unwinding the diag stack).
+              //
+              // If the scope was executed synchronously, check the status
+              // and bail out if we weren't asked to keep going.
+              //
+              const diag_frame* df (diag_frame::stack); // UBSan workaround.
+              if (!sched.async (task_count,
+                                [] (const diag_frame* ds,
+                                    scope& s,
+                                    script& scr,
+                                    runner& r)
+                                {
+                                  diag_frame::stack_guard dsg (ds);
+                                  execute_impl (s, scr, r);
+                                },
+                                df,
+                                ref (*s),
+                                ref (*script_),
+                                ref (*runner_)))
+              {
+                // Bail out if the scope has failed and we weren't instructed
+                // to keep going.
                 //
-                const diag_frame* df (diag_frame::stack); // UBSan workaround.
-                if (!sched.async (task_count,
-                                  [] (const diag_frame* ds,
-                                      scope& s,
-                                      script& scr,
-                                      runner& r)
-                                  {
-                                    diag_frame::stack_guard dsg (ds);
-                                    execute_impl (s, scr, r);
-                                  },
-                                  df,
-                                  ref (*chain),
-                                  ref (*script_),
-                                  ref (*runner_)))
-                {
-                  // Bail out if the scope has failed and we weren't instructed
-                  // to keep going.
-                  //
-                  if (chain->state == scope_state::failed && !keep_going)
-                    throw failed ();
-                }
+                if (s->state == scope_state::failed && !keep_going)
+                  throw failed ();
               }
             }
 
@@ -3312,6 +3498,8 @@ namespace build2
           slock sl (script_->var_pool_mutex);
           pvar = script_->var_pool.find (name);
         }
+        else
+          pre_parse_lookup_ = true;
 
         return pvar != nullptr
           ? scope_->find (*pvar)
@@ -27,6 +27,10 @@ namespace build2
       {
         // Pre-parse. Issue diagnostics and throw failed in case of an error.
         //
+        // The first version reads the testscript file of the script target
+        // and reuses the result of pre-parsing the same testscript for
+        // another target, if any (see parser.cxx for details).
+        //
       public:
         void
         pre_parse (script&);
@@ -191,6 +195,18 @@ namespace build2
         bool
         exec_lines (lines::iterator, lines::iterator, size_t&, command_type);
 
+        // Copy the pre-parse data of a (cached) scope into another script.
+        //
+      protected:
+        static void
+        copy_pre_parse (const scope& src, scope& dst, script&);
+
+        static unique_ptr<scope>
+        clone_pre_parse (const scope& src, group& parent, script&);
+
+        static line
+        copy_pre_parse (const line&, script&);
+
         // Customization hooks.
         //
       protected:
@@ -238,6 +254,12 @@ namespace build2
         lexer* lexer_;
         string id_prefix_; // Auto-derived id prefix.
 
+        // Set if any variables were looked up while pre-parsing (which can
+        // only happen in directives). Such a pre-parse result may depend on
+        // the target being tested and so cannot be reused.
+        //
+        bool pre_parse_lookup_;
+
         // Execute state.
         //
         runner* runner_;
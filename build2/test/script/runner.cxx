@@ -4,8 +4,16 @@
 
 #include <build2/test/script/runner.hxx>
 
+#ifndef _WIN32
+#  include <signal.h>       // kill(), SIGKILL
+#  include <sys/wait.h>     // wait4(), WNOHANG
+#  include <sys/resource.h> // rusage
+#endif
+
 #include <set>
-#include <ios> // streamsize
+#include <ios>    // streamsize
+#include <thread> // this_thread::sleep_for()
+#include <cerrno>
 
 #include <libbutl/regex.mxx>
 #include <libbutl/fdstream.mxx> // fdopen_mode, fdnull(), fddup()
@@ -15,6 +23,7 @@
 #include <build2/diagnostics.hxx>
 
 #include <build2/test/common.hxx>
+#include <build2/test/history.hxx>
 
 #include <build2/test/script/regex.hxx>
 #include <build2/test/script/parser.hxx>
@@ -695,6 +704,57 @@ namespace build2
         return common_.test (s.root->test_target, s.id_path);
       }
 
+      void default_runner::
+      order (vector<scope*>& ss)
+      {
+        if (ss.size () < 2)
+          return;
+
+        const target& t (ss.front ()->root->test_target);
+        const history& h (history::instance (t));
+
+        vector<pair<const history::entry*, scope*>> es;
+        es.reserve (ss.size ());
+
+        for (scope* s: ss)
+          es.emplace_back (h.find (history::key (t, s->id_path)), s);
+
+        stable_sort (es.begin (), es.end (),
+                     [] (const pair<const history::entry*, scope*>& x,
+                         const pair<const history::entry*, scope*>& y)
+                     {
+                       return history::before (x.first, y.first);
+                     });
+
+        for (size_t i (0); i != es.size (); ++i)
+          ss[i] = es[i].second;
+      }
+
+      void default_runner::
+      complete (scope& s, duration d)
+      {
+        const target& t (s.root->test_target);
+
+        history::instance (t).insert (history::key (t, s.id_path),
+                                      d,
+                                      s.state == scope_state::failed,
+                                      0 /* reruns */,
+                                      s.cpu_time,
+                                      s.max_rss);
+
+        // Nested scopes can complete concurrently.
+        //
+        if (scope* p = s.parent)
+        {
+          mlock l (usage_mutex_);
+
+          p->cpu_time += s.cpu_time;
+
+          if (p->max_rss < s.max_rss)
+            p->max_rss = s.max_rss;
+        }
+      }
+
       void default_runner::
       enter (scope& sp, const location&)
       {
@@ -734,6 +794,20 @@ namespace build2
           text << "cd " << sp.wd_path;
 
         sp.clean ({cleanup_type::always, sp.wd_path}, true);
+
+        // Calculate the scope execution deadline which cannot be past the
+        // outer scope's one.
+        //
+        sp.command_timeout = common_.command_timeout;
+
+        if (common_.scope_timeout)
+          sp.deadline = system_clock::now () + *common_.scope_timeout;
+
+        if (sp.parent != nullptr && sp.parent->deadline)
+        {
+          if (!sp.deadline || *sp.parent->deadline < *sp.deadline)
+            sp.deadline = sp.parent->deadline;
+        }
       }
 
       void default_runner::
@@ -1151,6 +1225,97 @@ namespace build2
         }
       }
 
+      // Wait for the process to terminate, adding the resources it consumed
+      // to the scope's usage. If the deadline is specified and expires, then
+      // kill the process and return false.
+      //
+      // Note that we only kill the process itself, not any processes it may
+      // have spawned (each command in a pipeline is a separate process that
+      // is waited for with its own deadline).
+      //
+      static bool
+      wait_process (process& pr,
+                    const optional<timestamp>& dl,
+                    scope& sp,
+                    const location& ll)
+      {
+#ifndef _WIN32
+        bool r (true);
+
+        int st;
+        rusage ru;
+
+        // Poll with exponential backoff if we have a deadline and block
+        // otherwise (or once the process is killed).
+        //
+        bool poll (dl);
+
+        for (duration d (chrono::milliseconds (1));; )
+        {
+          pid_t p (wait4 (pr.handle, &st, poll ? WNOHANG : 0, &ru));
+
+          if (p == -1)
+          {
+            if (errno == EINTR)
+              continue;
+
+            fail (ll) << "unable to wait for process " << pr.handle << ": "
+                      << system_error (errno, generic_category ());
+          }
+
+          if (p != 0)
+            break;
+
+          timestamp now (system_clock::now ());
+
+          if (now >= *dl)
+          {
+            if (::kill (pr.handle, SIGKILL) == -1 && errno != ESRCH)
+              fail (ll) << "unable to kill process " << pr.handle << ": "
+                        << system_error (errno, generic_category ());
+
+            poll = false;
+            r = false;
+            continue;
+          }
+
+          this_thread::sleep_for (min (d, *dl - now));
+
+          if (d < chrono::milliseconds (100))
+            d *= 2;
+        }
+
+        pr.handle = 0;
+        pr.exit = process_exit (st, process_exit::as_status);
+
+        auto usec = [] (const timeval& tv)
+        {
+          return chrono::seconds (tv.tv_sec) +
+            chrono::microseconds (tv.tv_usec);
+        };
+
+        sp.cpu_time += usec (ru.ru_utime) + usec (ru.ru_stime);
+
+        // On Mac OS ru_maxrss is in bytes rather than kilobytes.
+        //
+#ifdef __APPLE__
+        uint64_t rss (static_cast<uint64_t> (ru.ru_maxrss) / 1024);
+#else
+        uint64_t rss (static_cast<uint64_t> (ru.ru_maxrss));
+#endif
+        if (sp.max_rss < rss)
+          sp.max_rss = rss;
+
+        return r;
+#else
+        // @@ TODO: timeouts and resource usage (WaitForSingleObject(),
+        //    GetProcessTimes(), GetProcessMemoryInfo()).
+        //
+        pr.wait ();
+        return true;
+#endif
+      }
+
       static bool
       run_pipe (scope& sp,
                 command_pipe::const_iterator bc,
@@ -1671,17 +1836,44 @@ namespace build2
               {ifd.get (), -1}, process::pipe (ofd), {-1, efd.get ()},
               sp.wd_path.string ().c_str ());
 
+            // Calculate the command deadline as of the process start (rather
+            // than once the rest of the pipeline has completed). Note that it
+            // cannot be past the scope's one.
+            //
+            optional<timestamp> dl (sp.deadline);
+
+            if (sp.command_timeout)
+            {
+              timestamp d (system_clock::now () + *sp.command_timeout);
+
+              if (!dl || d < *dl)
+                dl = d;
+            }
+
             ifd.reset ();
             ofd.out.reset ();
             efd.reset ();
 
-            success = run_pipe (sp,
-                                nc,
-                                ec,
-                                move (ofd.in),
-                                ci + 1, li, ll, diag);
+            try
+            {
+              success = run_pipe (sp,
+                                  nc,
+                                  ec,
+                                  move (ofd.in),
+                                  ci + 1, li, ll, diag);
+            }
+            catch (const failed&)
+            {
+              // Don't let the process (which may well be blocked writing to
+              // the failed rest of the pipeline) outlive its deadline.
+              //
+              wait_process (pr, dl, sp, ll);
+              throw;
+            }
 
-            pr.wait ();
+            if (!wait_process (pr, dl, sp, ll))
+              fail (ll) << c.program << " terminated: execution timeout "
+                        << "expired";
 
             exit = move (pr.exit);
           }
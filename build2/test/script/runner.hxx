@@ -65,6 +65,18 @@ namespace build2
         //
         virtual void
         leave (scope&, const location&) = 0;
+
+        // Reorder the inner scopes of a group before they are started. The
+        // default implementation keeps the declaration order.
+        //
+        virtual void
+        order (vector<scope*>&) {}
+
+        // Called once the scope has been executed (successfully or not) with
+        // the time it took. Can be called concurrently for different scopes.
+        //
+        virtual void
+        complete (scope&, duration) {}
       };
 
       class default_runner: public runner
@@ -91,8 +103,18 @@ namespace build2
         virtual void
         leave (scope&, const location&) override;
 
+        // Start the previously failed and then the longest scopes first and
+        // record the results for the next run (see test::history).
+        //
+        virtual void
+        order (vector<scope*>&) override;
+
+        virtual void
+        complete (scope&, duration) override;
+
       private:
         const common& common_;
+        mutex usage_mutex_; // Outer scope resource usage.
       };
     }
   }
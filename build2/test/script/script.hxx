@@ -363,6 +363,19 @@ namespace build2
         test::script::cleanups cleanups;
         paths special_cleanups;
 
+        // Execution deadline and command timeout (see config.test.timeout)
+        // which are absent if there is no timeout. Set by the runner.
+        //
+        optional<timestamp> deadline;
+        optional<duration> command_timeout;
+
+        // Resources (CPU time and maximum resident set size in kilobytes)
+        // consumed by the processes executed in this scope and, once they
+        // are complete, in its nested scopes.
+        //
+        duration cpu_time = duration::zero ();
+        uint64_t max_rss = 0;
+
         // Variables.
         //
       public:
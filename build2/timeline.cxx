@@ -0,0 +1,311 @@
+// file      : build2/timeline.cxx -*- C++ -*-
+// copyright : Copyright (c) 2014-2019 Code Synthesis Ltd
+// license   : MIT; see accompanying LICENSE file
+
+#include <build2/timeline.hxx>
+
+#include <map>
+#include <cstring> // strchr()
+
+using namespace std;
+using namespace butl;
+
+namespace build2
+{
+  bool timeline_enabled_ = false;
+
+  struct timeline_event
+  {
+    const char* category;
+    string name;
+    timestamp start;
+    timestamp end;
+    timeline_args args;
+    uint64_t async; // Async event id or 0 if complete.
+  };
+
+  struct timeline_buffer
+  {
+    size_t thread; // Sequential thread number starting from 1.
+    vector<timeline_event> events;
+  };
+
+  static timestamp timeline_start;
+
+  static mutex timeline_mutex;
+  static vector<unique_ptr<timeline_buffer>> timeline_buffers;
+
+  static uint64_t timeline_async_id;                        // Next async id.
+  static std::map<const char* const*, timestamp> timeline_processes;
+
+  static
+#ifdef __cpp_thread_local
+  thread_local
+#else
+  __thread
+#endif
+  timeline_buffer* timeline_thread_buffer = nullptr;
+
+  // Return this thread's buffer, creating it on first use. Note that the
+  // buffers are owned by the global list so that they outlive the threads.
+  //
+  static timeline_buffer&
+  buffer ()
+  {
+    timeline_buffer* b (timeline_thread_buffer);
+
+    if (b == nullptr)
+    {
+      mlock l (timeline_mutex);
+
+      timeline_buffers.push_back (
+        unique_ptr<timeline_buffer> (
+          new timeline_buffer {timeline_buffers.size () + 1, {}}));
+
+      b = timeline_thread_buffer = timeline_buffers.back ().get ();
+    }
+
+    return *b;
+  }
+
+  void
+  timeline_enable ()
+  {
+    timeline_start = system_clock::now ();
+    timeline_enabled_ = true;
+  }
+
+  void
+  timeline_record (const char* c,
+                   string n,
+                   timestamp s,
+                   timestamp e,
+                   timeline_args as)
+  {
+    if (timeline_enabled_)
+      buffer ().events.push_back (
+        timeline_event {c, move (n), s, e, move (as), 0});
+  }
+
+  void
+  timeline_record_async (const char* c,
+                         string n,
+                         timestamp s,
+                         timestamp e,
+                         timeline_args as)
+  {
+    if (timeline_enabled_)
+    {
+      uint64_t id;
+      {
+        mlock l (timeline_mutex);
+        id = ++timeline_async_id;
+      }
+
+      buffer ().events.push_back (
+        timeline_event {c, move (n), s, e, move (as), id});
+    }
+  }
+
+  void
+  timeline_process_start (const char* const* args)
+  {
+    if (timeline_enabled_)
+    {
+      timestamp s (system_clock::now ());
+
+      mlock l (timeline_mutex);
+      timeline_processes[args] = s;
+    }
+  }
+
+  void
+  timeline_process_finish (const char* const* args)
+  {
+    if (!timeline_enabled_)
+      return;
+
+    timestamp e (system_clock::now ());
+    timestamp s;
+    {
+      mlock l (timeline_mutex);
+
+      auto i (timeline_processes.find (args));
+      if (i == timeline_processes.end ())
+        return;
+
+      s = i->second;
+      timeline_processes.erase (i);
+    }
+
+    string cmd;
+    for (const char* const* a (args); *a != nullptr; ++a)
+    {
+      if (a != args)
+        cmd += ' ';
+
+      bool q (strchr (*a, ' ') != nullptr);
+
+      if (q) cmd += '"';
+      cmd += *a;
+      if (q) cmd += '"';
+    }
+
+    timeline_args as;
+    as.push_back (make_pair ("command", move (cmd)));
+
+    timeline_record_async ("process",
+                           path (args[0]).leaf ().string (),
+                           s,
+                           e,
+                           move (as));
+  }
+
+  static void
+  to_json (string& r, const string& s)
+  {
+    r += '"';
+
+    for (char c: s)
+    {
+      switch (c)
+      {
+      case '"':  r += "\\\""; break;
+      case '\\': r += "\\\\"; break;
+      case '\n': r += "\\n";  break;
+      case '\r': r += "\\r";  break;
+      case '\t': r += "\\t";  break;
+      default:
+        {
+          if (static_cast<unsigned char> (c) < 0x20)
+          {
+            const char* h ("0123456789abcdef");
+
+            r += "\\u00";
+            r += h[(c >> 4) & 0x0f];
+            r += h[c & 0x0f];
+          }
+          else
+            r += c;
+        }
+      }
+    }
+
+    r += '"';
+  }
+
+  void
+  timeline_write (const path& f)
+  {
+    using namespace chrono;
+
+    auto us = [] (timestamp t) -> uint64_t
+    {
+      return t > timeline_start
+        ? duration_cast<microseconds> (t - timeline_start).count ()
+        : 0;
+    };
+
+    ofdstream os (f);
+
+    os << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+
+    bool first (true);
+    string e;
+
+    auto write = [&os, &first, &e] ()
+    {
+      if (!first)
+        os << ',';
+
+      os << '\n' << e;
+
+      first = false;
+      e.clear ();
+    };
+
+    for (const unique_ptr<timeline_buffer>& b: timeline_buffers)
+    {
+      string tid (to_string (b->thread));
+
+      e += "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": ";
+      e += tid;
+      e += ", \"args\": {\"name\": \"thread ";
+      e += tid;
+      e += "\"}}";
+      write ();
+
+      for (const timeline_event& v: b->events)
+      {
+        auto common = [&e, &v, &tid] (const char* ph)
+        {
+          e += "{\"name\": ";
+          to_json (e, v.name);
+          e += ", \"cat\": \"";
+          e += v.category;
+          e += "\", \"ph\": \"";
+          e += ph;
+          e += "\", \"pid\": 1, \"tid\": ";
+          e += tid;
+
+          if (v.async != 0)
+          {
+            e += ", \"id\": ";
+            e += to_string (v.async);
+          }
+        };
+
+        auto args = [&e, &v] ()
+        {
+          if (v.args.empty ())
+            return;
+
+          e += ", \"args\": {";
+          for (size_t i (0); i != v.args.size (); ++i)
+          {
+            if (i != 0)
+              e += ", ";
+
+            e += '"';
+            e += v.args[i].first;
+            e += "\": ";
+            to_json (e, v.args[i].second);
+          }
+          e += '}';
+        };
+
+        uint64_t s (us (v.start)), n (us (v.end)), d (n > s ? n - s : 0);
+
+        if (v.async == 0)
+        {
+          common ("X");
+          e += ", \"ts\": ";
+          e += to_string (s);
+          e += ", \"dur\": ";
+          e += to_string (d);
+          args ();
+          e += '}';
+          write ();
+        }
+        else
+        {
+          common ("b");
+          e += ", \"ts\": ";
+          e += to_string (s);
+          args ();
+          e += '}';
+          write ();
+
+          common ("e");
+          e += ", \"ts\": ";
+          e += to_string (s + d);
+          e += '}';
+          write ();
+        }
+      }
+    }
+
+    os << '\n' << "]}" << '\n';
+    os.close ();
+  }
+}
@@ -0,0 +1,104 @@
+// file      : build2/timeline.hxx -*- C++ -*-
+// copyright : Copyright (c) 2014-2019 Code Synthesis Ltd
+// license   : MIT; see accompanying LICENSE file
+
+#ifndef BUILD2_TIMELINE_HXX
+#define BUILD2_TIMELINE_HXX
+
+#include <build2/types.hxx>
+#include <build2/utility.hxx>
+
+namespace build2
+{
+  // Build timeline in the Chrome trace event format (also understood by
+  // Perfetto; see --trace-file).
+  //
+  // Events are recorded into per-thread buffers without any locking and are
+  // only written out by timeline_write() which should be called once all
+  // the threads are quiescent (for example, after the scheduler shutdown).
+  // If the timeline is not enabled, then recording an event amounts to
+  // testing a pointer.
+  //
+  struct timeline_buffer;
+
+  // Enable recording. Should be called before starting any threads.
+  //
+  void
+  timeline_enable ();
+
+  inline bool
+  timeline_enabled ();
+
+  // Write the recorded events into the specified file. Throw io_error if
+  // unable to write.
+  //
+  void
+  timeline_write (const path&);
+
+  // Record a complete event on this thread. The category should be a
+  // string literal. The arguments are key/value pairs that are shown as
+  // the event details.
+  //
+  using timeline_args = small_vector<pair<const char*, string>, 1>;
+
+  void
+  timeline_record (const char* category,
+                   string name,
+                   timestamp start,
+                   timestamp end,
+                   timeline_args = timeline_args ());
+
+  // Record an asynchronous (not nested within the other events on this
+  // thread) event, such as an external process run.
+  //
+  void
+  timeline_record_async (const char* category,
+                         string name,
+                         timestamp start,
+                         timestamp end,
+                         timeline_args = timeline_args ());
+
+  // Record the span between construction and destruction as a complete
+  // event on this thread. The name and arguments are expected to be set by
+  // the user but only if the span is active (so that we don't format them
+  // for nothing). For example:
+  //
+  // timeline_span s ("match");
+  // if (s)
+  //   s.name = to_string (t);
+  //
+  class timeline_span
+  {
+  public:
+    explicit
+    timeline_span (const char* category);
+
+    ~timeline_span ();
+
+    explicit operator bool () const {return category_ != nullptr;}
+
+    string name;
+    timeline_args args;
+
+    timeline_span (const timeline_span&) = delete;
+    timeline_span& operator= (const timeline_span&) = delete;
+
+  private:
+    const char* category_;
+    timestamp start_;
+  };
+
+  // Start/finish the run of an external process started by run_start()
+  // (see utility.hxx). The process is identified by its arguments array
+  // which should be the same for both calls.
+  //
+  void
+  timeline_process_start (const char* const* args);
+
+  void
+  timeline_process_finish (const char* const* args);
+}
+
+#include <build2/timeline.ixx>
+
+#endif // BUILD2_TIMELINE_HXX
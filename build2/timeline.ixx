@@ -0,0 +1,33 @@
+// file      : build2/timeline.ixx -*- C++ -*-
+// copyright : Copyright (c) 2014-2019 Code Synthesis Ltd
+// license   : MIT; see accompanying LICENSE file
+
+namespace build2
+{
+  extern bool timeline_enabled_;
+
+  inline bool
+  timeline_enabled ()
+  {
+    return timeline_enabled_;
+  }
+
+  inline timeline_span::
+  timeline_span (const char* c)
+      : category_ (timeline_enabled_ ? c : nullptr)
+  {
+    if (category_ != nullptr)
+      start_ = system_clock::now ();
+  }
+
+  inline timeline_span::
+  ~timeline_span ()
+  {
+    if (category_ != nullptr)
+      timeline_record (category_,
+                       move (name),
+                       start_,
+                       system_clock::now (),
+                       move (args));
+  }
+}
@@ -10,6 +10,7 @@
 #include <iostream> // cerr
 
 #include <build2/target.hxx>
+#include <build2/timeline.hxx>
 #include <build2/variable.hxx>
 #include <build2/diagnostics.hxx>
 
@@ -189,6 +190,8 @@ namespace build2
     if (verb >= verbosity)
       print_process (args, 0);
 
+    timeline_process_start (args);
+
     return process (
       *pe.path,
       args,
@@ -228,7 +231,10 @@ namespace build2
   {
     tracer trace ("run_finish");
 
-    if (pr.wait ())
+    bool r (pr.wait ());
+    timeline_process_finish (args);
+
+    if (r)
       return true;
 
     const process_exit& e (*pr.exit);
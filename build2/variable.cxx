@@ -1272,7 +1272,8 @@ namespace build2
           nullptr,
           t,
           nullptr,
-          v != nullptr ? *v : variable_visibility::normal}));
+          v != nullptr ? *v : variable_visibility::normal,
+          map_.size ()}));
 
     variable& r (p.first->second);
 
@@ -1517,6 +1518,21 @@ namespace build2
     return lookup ();
   }
 
+  bool variable_type_map::
+  contains (const variable& var) const
+  {
+    for (const auto& p: map_)
+    {
+      for (const auto& q: p.second)
+      {
+        if (q.second.find (var, false).first != nullptr)
+          return true;
+      }
+    }
+
+    return false;
+  }
+
   size_t variable_cache_mutex_shard_size;
   unique_ptr<shared_mutex[]> variable_cache_mutex_shard;
 }
@@ -16,6 +16,7 @@
 #include <build2/types.hxx>
 #include <build2/utility.hxx>
 
+#include <build2/memory.hxx>
 #include <build2/target-type.hxx>
 
 namespace build2
@@ -178,6 +179,12 @@ namespace build2
     unique_ptr<const variable> override;
     variable_visibility visibility;
 
+    // Dense (per pool) variable id that can be used to index into flat
+    // tables (see scope_lookup_cache for an example). Note that the ids
+    // of aliases are distinct and override variables all have id 0.
+    //
+    size_t id;
+
     // Return true if this variable is an alias of the specified variable.
     //
     bool
@@ -1123,7 +1130,13 @@ namespace build2
     //
   private:
     using key = butl::map_key<string>;
-    using map = std::unordered_map<key, variable>;
+    using map = std::unordered_map<
+      key,
+      variable,
+      std::hash<key>,
+      std::equal_to<key>,
+      counting_allocator<pair<const key, variable>,
+                         memory_subsystem::variables>>;
 
     pair<map::iterator, bool>
     insert (variable&& var)
@@ -1379,27 +1392,84 @@ namespace build2
   // the references remain valid).
   //
   // Note that since the cache can be modified on any lookup (including during
-  // the execute phase), it is protected by its own mutex shard (allocated in
-  // main()). This shard is also used for value typification (which is kind of
-  // like caching) during concurrent execution phases.
+  // the execute phase), its modifications are protected by its own mutex
+  // shard (allocated in main()). This shard is also used for value
+  // typification (which is kind of like caching) during concurrent execution
+  // phases. Cache hits, however, are lock-free: the entries are kept in an
+  // open-addressing hash table of pointers (which is replaced on growth with
+  // the old tables retained until the cache is destroyed) and each entry has
+  // a sequence number that is odd while it is being (re)populated (seqlock).
   //
   extern size_t variable_cache_mutex_shard_size;
   extern unique_ptr<shared_mutex[]> variable_cache_mutex_shard;
 
+  // Exclusive access to the cache entry returned by variable_cache::insert().
+  // On unlock the entry becomes visible to the lock-free readers.
+  //
+  class variable_cache_lock
+  {
+  public:
+    bool
+    owns_lock () const {return l_.owns_lock ();}
+
+    void
+    unlock ()
+    {
+      if (seq_ != nullptr)
+      {
+        seq_->fetch_add (1, memory_order_release); // Even.
+        seq_ = nullptr;
+      }
+
+      l_.unlock ();
+    }
+
+    variable_cache_lock () = default;
+
+    variable_cache_lock (ulock&& l, atomic<size_t>* s)
+        : l_ (move (l)), seq_ (s) {}
+
+    variable_cache_lock (variable_cache_lock&& x)
+        : l_ (move (x.l_)), seq_ (x.seq_) {x.seq_ = nullptr;}
+
+    variable_cache_lock& operator= (variable_cache_lock&&) = delete;
+
+    ~variable_cache_lock ()
+    {
+      if (owns_lock ())
+        unlock ();
+    }
+
+  private:
+    ulock l_;
+    atomic<size_t>* seq_ = nullptr;
+  };
+
   template <typename K>
   class variable_cache
   {
   public:
-    // If the returned unique lock is locked, then the value has been
-    // invalidated. If the variable type does not match the value type,
-    // then typify the cached value.
+    // If the returned lock is locked, then the value has been invalidated.
+    // If the variable type does not match the value type, then typify the
+    // cached value.
     //
-    pair<value&, ulock>
+    pair<value&, variable_cache_lock>
     insert (K, const lookup& stem, size_t version, const variable&);
 
+    variable_cache () = default;
+
+    // Only an empty cache can be moved (scope, variable_type_map).
+    //
+    variable_cache (variable_cache&& c)
+    {
+      assert (c.entries_.empty ());
+    }
+
   private:
     struct entry_type
     {
+      const K key;
+
       // Note: we use value_data instead of value since the result is often
       // returned as lookup. We also maintain the version in case one cached
       // value (e.g., override) is based on another (e.g., target
@@ -1407,31 +1477,54 @@ namespace build2
       //
       variable_map::value_data value;
 
-      size_t version = 0; // Version on which this value is based.
+      // Odd while the entry is being (re)populated.
+      //
+      atomic<size_t> seq {1};
+
+      // Version on which this value is based.
+      //
+      relaxed_atomic<size_t> version;
 
       // Location of the stem as well as the version on which this cache
       // value is based. Used to track the location and value of the stem
       // for cache invalidation. NULL/0 means there is no stem.
       //
-      const variable_map* stem_vars = nullptr;
-      size_t              stem_version = 0;
+      relaxed_atomic<const variable_map*> stem_vars;
+      relaxed_atomic<size_t>              stem_version;
 
-      // For GCC 4.9.
-      //
-      entry_type () = default;
-      entry_type (variable_map::value_data val,
+      entry_type (K k,
+                  variable_map::value_data val,
                   size_t ver,
                   const variable_map* svars,
                   size_t sver)
-          : value (move (val)),
+          : key (move (k)),
+            value (move (val)),
             version (ver),
             stem_vars (svars),
             stem_version (sver) {}
     };
 
-    using map_type = std::map<K, entry_type>;
+    struct table
+    {
+      size_t mask; // Capacity - 1.
+      unique_ptr<atomic<entry_type*>[]> entries;
+    };
 
-    map_type m_;
+    static size_t
+    hash (const pair<const variable*, const variable_map*>&);
+
+    static size_t
+    hash (const tuple<const value*, const target_type*, string>&);
+
+    entry_type*
+    find (const K&, size_t hash) const;
+
+    atomic<const table*> table_ {nullptr};
+
+    // The following members are protected by the mutex shard.
+    //
+    vector<unique_ptr<table>> tables_;       // Retired followed by current.
+    vector<unique_ptr<entry_type>> entries_; // Never removed.
   };
 
   // Target type/pattern-specific variables.
@@ -1439,7 +1532,12 @@ namespace build2
   class variable_pattern_map
   {
   public:
-    using map_type = std::map<string, variable_map>;
+    using map_type = std::map<
+      string,
+      variable_map,
+      std::less<string>,
+      counting_allocator<pair<const string, variable_map>,
+                         memory_subsystem::variables>>;
     using const_iterator = map_type::const_iterator;
     using const_reverse_iterator = map_type::const_reverse_iterator;
 
@@ -1466,8 +1564,13 @@ namespace build2
   class variable_type_map
   {
   public:
-    using map_type = std::map<reference_wrapper<const target_type>,
-                              variable_pattern_map>;
+    using map_type = std::map<
+      reference_wrapper<const target_type>,
+      variable_pattern_map,
+      std::less<reference_wrapper<const target_type>>,
+      counting_allocator<pair<const reference_wrapper<const target_type>,
+                              variable_pattern_map>,
+                         memory_subsystem::variables>>;
     using const_iterator = map_type::const_iterator;
 
     explicit
@@ -1486,6 +1589,12 @@ namespace build2
     lookup
     find (const target_type&, const string& tname, const variable&) const;
 
+    // Return true if there is a value for this variable for any target
+    // type/pattern.
+    //
+    bool
+    contains (const variable&) const;
+
     // Prepend/append value cache.
     //
     // The key is the combination of the "original value identity" (as a
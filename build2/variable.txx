@@ -585,8 +585,57 @@ namespace build2
 
   // variable_cache
   //
+  static inline size_t
+  variable_cache_hash (size_t h, size_t v)
+  {
+    return h ^ (v + 0x9e3779b9 + (h << 6) + (h >> 2));
+  }
+
+  template <typename K>
+  inline size_t variable_cache<K>::
+  hash (const pair<const variable*, const variable_map*>& k)
+  {
+    return variable_cache_hash (std::hash<const variable*> () (k.first),
+                                std::hash<const variable_map*> () (k.second));
+  }
+
+  template <typename K>
+  inline size_t variable_cache<K>::
+  hash (const tuple<const value*, const target_type*, string>& k)
+  {
+    size_t h (std::hash<const value*> () (get<0> (k)));
+    h = variable_cache_hash (h, std::hash<const target_type*> () (get<1> (k)));
+    h = variable_cache_hash (h, std::hash<string> () (get<2> (k)));
+    return h;
+  }
+
+  template <typename K>
+  auto variable_cache<K>::
+  find (const K& k, size_t h) const -> entry_type*
+  {
+    const table* t (table_.load (memory_order_acquire));
+
+    if (t != nullptr)
+    {
+      // Note that the table is never full.
+      //
+      for (size_t i (h & t->mask);; i = (i + 1) & t->mask)
+      {
+        entry_type* e (t->entries[i].load (memory_order_acquire));
+
+        if (e == nullptr)
+          break;
+
+        if (e->key == k)
+          return e;
+      }
+    }
+
+    return nullptr;
+  }
+
   template <typename K>
-  pair<value&, ulock> variable_cache<K>::
+  pair<value&, variable_cache_lock> variable_cache<K>::
   insert (K k, const lookup& stem, size_t ver, const variable& var)
   {
     using value_data = variable_map::value_data;
@@ -596,75 +645,131 @@ namespace build2
                  ? static_cast<const value_data*> (stem.value)->version
                  : 0);
 
-    shared_mutex& m (
-      variable_cache_mutex_shard[
-        hash<variable_cache*> () (this) % variable_cache_mutex_shard_size]);
+    size_t h (hash (k));
 
-    slock sl (m);
-    ulock ul (m, defer_lock);
+    // Cache hit (lock-free). Note that we have to re-check the sequence
+    // number after reading the entry's state to make sure it was not being
+    // modified at the same time.
+    //
+    entry_type* e (find (k, h));
 
-    auto i (m_.find (k));
+    if (e != nullptr)
+    {
+      size_t s (e->seq.load (memory_order_acquire));
 
-    // Cache hit.
-    //
-    if (i != m_.end ()                 &&
-        i->second.version == ver       &&
-        i->second.stem_vars == svars   &&
-        i->second.stem_version == sver &&
-        (var.type == nullptr || i->second.value.type == var.type))
-      return pair<value&, ulock> (i->second.value, move (ul));
-
-    // Relock for exclusive access. Note that it is entirely possible
-    // that between unlock and lock someone else has updated the entry.
-    //
-    sl.unlock ();
-    ul.lock ();
+      if ((s & 1) == 0                &&
+          e->version == ver           &&
+          e->stem_vars == svars       &&
+          e->stem_version == sver     &&
+          (var.type == nullptr || e->value.type == var.type))
+      {
+        std::atomic_thread_fence (memory_order_acquire);
 
-    // Note that the cache entries are never removed so we can reuse the
-    // iterator.
-    //
-    pair<typename map_type::iterator, bool> p (i, i == m_.end ());
+        if (e->seq.load (memory_order_relaxed) == s)
+          return pair<value&, variable_cache_lock> (
+            e->value, variable_cache_lock ());
+      }
+    }
 
-    if (p.second)
-      p = m_.emplace (move (k),
-                      entry_type {value_data (nullptr), ver, svars, sver});
+    ulock ul (
+      variable_cache_mutex_shard[
+        std::hash<variable_cache*> () (this) %
+        variable_cache_mutex_shard_size]);
 
-    entry_type& e (p.first->second);
+    // Note that it is entirely possible that while we were acquiring the
+    // lock someone else has inserted or updated the entry.
+    //
+    if (e == nullptr)
+      e = find (k, h);
 
-    if (p.second)
+    if (e == nullptr)
     {
       // Cache miss.
       //
-      e.value.version++; // New value.
+      entries_.push_back (
+        unique_ptr<entry_type> (
+          new entry_type (move (k), value_data (nullptr), ver, svars, sver)));
+
+      e = entries_.back ().get ();
+      e->value.version++; // New value.
+
+      // Insert the new entry into the table growing it if it is about to
+      // become more than half full.
+      //
+      table* t (tables_.empty () ? nullptr : tables_.back ().get ());
+
+      auto place = [] (table& t, entry_type* e, size_t h)
+      {
+        size_t i (h & t.mask);
+        for (; t.entries[i].load (memory_order_relaxed) != nullptr;
+             i = (i + 1) & t.mask) ;
+        t.entries[i].store (e, memory_order_release);
+      };
+
+      if (t == nullptr || entries_.size () * 2 > t->mask + 1)
+      {
+        size_t n (t != nullptr ? (t->mask + 1) * 2 : 16);
+
+        unique_ptr<table> nt (
+          new table {n - 1, unique_ptr<atomic<entry_type*>[]> (
+                              new atomic<entry_type*>[n])});
+
+        for (size_t i (0); i != n; ++i)
+          nt->entries[i].store (nullptr, memory_order_relaxed);
+
+        for (const unique_ptr<entry_type>& x: entries_)
+          place (*nt, x.get (), hash (x->key));
+
+        tables_.push_back (move (nt));
+        table_.store (tables_.back ().get (), memory_order_release);
+      }
+      else
+        place (*t, e, h);
+
+      // The sequence number is odd (see entry_type).
+      //
+      return pair<value&, variable_cache_lock> (
+        e->value, variable_cache_lock (move (ul), &e->seq));
     }
-    else if (e.version != ver     ||
-             e.stem_vars != svars ||
-             e.stem_version != sver)
+
+    if (e->version != ver     ||
+        e->stem_vars != svars ||
+        e->stem_version != sver)
     {
       // Cache invalidation.
       //
-      assert (e.version <= ver);
-      e.version = ver;
+      e->seq.fetch_add (1, memory_order_relaxed); // Odd.
+      std::atomic_thread_fence (memory_order_release);
+
+      assert (e->version <= ver);
+      e->version = ver;
 
-      if (e.stem_vars != svars)
-        e.stem_vars = svars;
+      if (e->stem_vars != svars)
+        e->stem_vars = svars;
       else
-        assert (e.stem_version <= sver);
+        assert (e->stem_version <= sver);
 
-      e.stem_version = sver;
+      e->stem_version = sver;
 
-      e.value.version++; // Value changed.
+      e->value.version++; // Value changed.
+
+      return pair<value&, variable_cache_lock> (
+        e->value, variable_cache_lock (move (ul), &e->seq));
     }
-    else
+
+    // Cache hit.
+    //
+    if (var.type != nullptr && e->value.type != var.type)
     {
-      // Cache hit.
-      //
-      if (var.type != nullptr && e.value.type != var.type)
-        typify (e.value, *var.type, &var);
+      e->seq.fetch_add (1, memory_order_relaxed); // Odd.
+      std::atomic_thread_fence (memory_order_release);
+
+      typify (e->value, *var.type, &var);
 
-      ul.unlock ();
+      e->seq.fetch_add (1, memory_order_release); // Even.
     }
 
-    return pair<value&, ulock> (e.value, move (ul));
+    return pair<value&, variable_cache_lock> (
+      e->value, variable_cache_lock ());
   }
 }
@@ -2,6 +2,10 @@
 // copyright : Copyright (c) 2014-2019 Code Synthesis Ltd
 // license   : MIT; see accompanying LICENSE file
 
+#include <chrono>
+#include <sstream>
+
+#include <cassert>
 #include <iostream>
 
 #include <build2/types.hxx>
@@ -33,12 +37,136 @@ namespace build2
   {
   }
 
+  extern size_t regex_cache_max; // functions-regex.cxx
+
+  // Generate a buildfile that calls $regex.match() and $regex.replace() for
+  // each of the specified number of names in a for-loop. The names (and thus
+  // the patterns, which are derived from them) cycle over the specified
+  // number of distinct values.
+  //
+  static string
+  generate (size_t names, size_t patterns)
+  {
+    ostringstream os;
+
+    os << "ns =";
+    for (size_t i (0); i != names; ++i)
+      os << " n" << i % patterns;
+    os << '\n';
+
+    os << "for n: $ns" << '\n'
+       << "  r = $regex.match($n, '('$n')') "
+       <<     "$regex.replace($n, '('$n')', 'x\\1')" << '\n';
+
+    return os.str ();
+  }
+
+  // Parse the buildfile the specified number of times returning the total
+  // duration.
+  //
+  static chrono::duration<double>
+  run (const string& bf, size_t iterations)
+  {
+    using namespace chrono;
+
+    scope& s (*scope::global_);
+    duration<double> r (0);
+
+    for (size_t i (0); i != iterations; ++i)
+    {
+      istringstream is (bf);
+
+      auto t (steady_clock::now ());
+
+      parser p;
+      p.parse_buildfile (is, path ("buildfile"), s, s);
+
+      r += steady_clock::now () - t;
+    }
+
+    return r;
+  }
+
+  // Usage: argv[0] [-n <names>] [-p <patterns>] [-i <iterations>]
+  //
+  // -n  number of names to match in a for-loop, for example 10000
+  // -p  number of distinct patterns, for example 300
+  // -i  number of times to parse the buildfile, for example 10
+  //
+  // Without options, parse the buildfile read from stdin (functional tests).
+  // Otherwise, benchmark the $regex.*() functions on a generated buildfile
+  // first without and then with the compiled regex cache and print the
+  // throughput (names per second) in the <name> <value> form suitable for
+  // regression tracking. Note that with more distinct patterns than the
+  // cache can hold every lookup misses.
+  //
   int
-  main (int, char* argv[])
+  main (int argc, char* argv[])
   {
+    bool bench (false);
+
+    size_t names (10000);
+    size_t patterns (10);
+    size_t iterations (1);
+
+    for (int i (1); i != argc; ++i)
+    {
+      string a (argv[i]);
+
+      if (a == "-n")
+        names = stoul (argv[++i]);
+      else if (a == "-p")
+        patterns = stoul (argv[++i]);
+      else if (a == "-i")
+        iterations = stoul (argv[++i]);
+      else
+        assert (false);
+
+      bench = true;
+    }
+
+    assert (names != 0 && patterns != 0 && iterations != 0);
+
     init (argv[0], 1);  // Fake build system driver, default verbosity.
     reset (strings ()); // No command line variables.
 
+    if (bench)
+    {
+      string bf (generate (names, patterns));
+
+      chrono::duration<double> ud (0); // Uncached.
+      chrono::duration<double> cd (0); // Cached.
+      try
+      {
+        size_t m (regex_cache_max);
+
+        regex_cache_max = 0;
+        ud = run (bf, iterations);
+
+        regex_cache_max = m;
+        cd = run (bf, iterations);
+      }
+      catch (const failed&)
+      {
+        return 1;
+      }
+
+      auto rate = [] (double n, const chrono::duration<double>& d) -> uint64_t
+      {
+        return d.count () != 0 ? static_cast<uint64_t> (n / d.count ()) : 0;
+      };
+
+      double n (static_cast<double> (names * iterations));
+
+      cerr << "names                  " << names            << endl
+           << "patterns               " << patterns         << endl
+           << "cache size             " << regex_cache_max  << endl
+           << "uncached names/sec     " << rate (n, ud)     << endl
+           << "cached names/sec       " << rate (n, cd)     << endl;
+
+      return 0;
+    }
+
     function_family f ("dummy");
 
     f["fail"]     = []()        {fail << "failed" << endf;};
@@ -0,0 +1,259 @@
+// file      : unit-tests/parser/driver.cxx -*- C++ -*-
+// copyright : Copyright (c) 2014-2019 Code Synthesis Ltd
+// license   : MIT; see accompanying LICENSE file
+
+#include <new>     // bad_alloc, get_new_handler()
+#include <chrono>
+#include <atomic>
+#include <sstream>
+#include <cstdlib> // malloc(), free()
+
+#include <cassert>
+#include <iostream>
+
+#include <build2/types.hxx>
+#include <build2/utility.hxx>
+
+#include <build2/file.hxx>
+#include <build2/scope.hxx>
+#include <build2/token.hxx>
+#include <build2/lexer.hxx>
+#include <build2/parser.hxx>
+#include <build2/target.hxx>
+#include <build2/context.hxx>
+#include <build2/variable.hxx>
+#include <build2/diagnostics.hxx>
+
+using namespace std;
+
+namespace build2
+{
+  // Number of heap allocations (see operator new below).
+  //
+  static std::atomic<uint64_t> allocations (0);
+
+  // Generate a synthetic buildfile with the specified number of targets
+  // spread over the directory scopes nested up to the specified depth. Each
+  // target comes with variable assignments that exercise the expansion,
+  // function calls, and for-loops. Return the number of targets declared.
+  //
+  static size_t
+  generate (ostream& os, size_t targets, size_t depth)
+  {
+    os << "v0 = a b c d e f g h" << '\n'
+       << "v1 = $v0 i j k" << '\n'
+       << "v2 = [strings] x y z" << '\n'
+       << '\n';
+
+    size_t per (targets / depth + (targets % depth != 0 ? 1 : 0));
+    size_t n (0);
+    size_t scopes (0); // Number of scopes opened.
+
+    for (size_t d (0); d != depth && n != targets; ++d, ++scopes)
+    {
+      os << "d" << d << "/" << '\n'
+         << "{" << '\n';
+
+      for (size_t i (0); i != per && n != targets; ++i, ++n)
+      {
+        os << "x" << n << " = $v0 \"t" << n << "-$v1\" ($v2)" << '\n'
+           << "file{t" << n << "}: file{s" << n << "}" << '\n'
+           << "file{t" << n << "}: y = $path.base(t" << n << ".txt) "
+           <<   "$name.name(file{t" << n << "}) $regex.replace(t" << n
+           <<   ".o, '(.+)\\.o', '\\1.c')" << '\n'
+           << "for v: $v0" << '\n'
+           << "  z" << n << " += $(v).o" << '\n';
+      }
+    }
+
+    // Close the scopes. Note that we may have opened fewer than depth of
+    // them if there are not enough targets to fill every level.
+    //
+    for (size_t d (0); d != scopes; ++d)
+      os << "}" << '\n';
+
+    return n;
+  }
+
+  // Usage argv[0] [-n <targets>] [-d <depth>] [-i <iterations>]
+  //
+  // -n  number of targets to declare, for example 10000
+  // -d  depth of the directory scope nesting, for example 50
+  // -i  number of times to lex and parse the buildfile, for example 10
+  //
+  // Generate a synthetic buildfile, lex it, and parse it in a fresh build
+  // state the specified number of times. Specifying any option also turns
+  // on the verbose mode in which case the throughput (tokens and buildfiles
+  // per second) as well as the number of heap allocations per token is
+  // printed. The output is in the <name> <value> form suitable for
+  // regression tracking.
+  //
+  int
+  main (int argc, char* argv[])
+  {
+    bool verb (false);
+
+    size_t count (100);
+    size_t depth (10);
+    size_t iterations (1);
+
+    for (int i (1); i != argc; ++i)
+    {
+      string a (argv[i]);
+
+      if (a == "-n")
+        count = stoul (argv[++i]);
+      else if (a == "-d")
+        depth = stoul (argv[++i]);
+      else if (a == "-i")
+        iterations = stoul (argv[++i]);
+      else
+        assert (false);
+
+      verb = true;
+    }
+
+    assert (count != 0 && depth != 0 && iterations != 0);
+
+    init (argv[0], 1);  // Fake build system driver, default verbosity.
+    reset (strings ()); // No command line variables.
+
+    string bf;
+    {
+      ostringstream os;
+      size_t n (generate (os, count, depth));
+      assert (n == count);
+      bf = os.str ();
+    }
+
+    path name ("buildfile");
+    dir_path root (work / dir_path ("bench"));
+
+    using namespace chrono;
+
+    // Lex.
+    //
+    // Note that the parser switches the lexer into other modes (variable
+    // value, etc) so the normal mode tokenization is an approximation.
+    //
+    size_t tokens (0);
+    duration<double> ld (0);
+    uint64_t la (0);
+    {
+      for (size_t i (0); i != iterations; ++i)
+      {
+        istringstream is (bf);
+        lexer l (is, name);
+
+        uint64_t a (allocations.load (memory_order_relaxed));
+        auto s (steady_clock::now ());
+
+        size_t n (0);
+        for (token t (l.next ()); t.type != token_type::eos; t = l.next ())
+          ++n;
+
+        ld += steady_clock::now () - s;
+        la += allocations.load (memory_order_relaxed) - a;
+
+        assert (tokens == 0 || tokens == n);
+        tokens = n;
+      }
+    }
+
+    // Parse.
+    //
+    duration<double> pd (0);
+    uint64_t pa (0);
+    {
+      for (size_t i (0); i != iterations; ++i)
+      {
+        reset (strings ());
+
+        // Setup the root scope as would be done for a real (in source)
+        // project so that the nested directory scopes can be entered.
+        //
+        auto ri (create_root (global_scope->rw (), root, root));
+        scope& rs (ri->second);
+        setup_root (rs, false /* forwarded */);
+        setup_base (ri, root, root);
+
+        istringstream is (bf);
+
+        uint64_t a (allocations.load (memory_order_relaxed));
+        auto s (steady_clock::now ());
+
+        try
+        {
+          parser p;
+          p.parse_buildfile (is, name, rs, rs);
+        }
+        catch (const failed&)
+        {
+          error << "unable to parse generated buildfile" <<
+            info << "targets " << count << ", depth " << depth;
+          return 1;
+        }
+
+        pd += steady_clock::now () - s;
+        pa += allocations.load (memory_order_relaxed) - a;
+
+        assert (targets.size () >= count * 2); // file{tN} and file{sN}.
+      }
+    }
+
+    if (verb)
+    {
+      auto rate = [] (double n, const duration<double>& d) -> uint64_t
+      {
+        return d.count () != 0 ? static_cast<uint64_t> (n / d.count ()) : 0;
+      };
+
+      size_t t (tokens * iterations);
+
+      cerr << "targets                " << count                     << endl
+           << "depth                  " << depth                     << endl
+           << "buildfile bytes        " << bf.size ()                << endl
+           << "buildfile tokens       " << tokens                    << endl
+           << "lexed tokens/sec       " << rate (t, ld)              << endl
+           << "lexer allocs/token     " << double (la) / t           << endl
+           << "parsed tokens/sec      " << rate (t, pd)              << endl
+           << "parsed buildfiles/sec  " << rate (iterations, pd)     << endl
+           << "parser allocs/token    " << double (pa) / t           << endl;
+    }
+
+    return 0;
+  }
+}
+
+// Replace the global allocation function to count the allocations. Note that
+// the rest of the allocation/deallocation functions end up calling these
+// two.
+//
+void*
+operator new (size_t n)
+{
+  build2::allocations.fetch_add (1, std::memory_order_relaxed);
+
+  for (;;)
+  {
+    if (void* p = malloc (n != 0 ? n : 1))
+      return p;
+
+    if (std::new_handler h = std::get_new_handler ())
+      h ();
+    else
+      throw std::bad_alloc ();
+  }
+}
+
+void
+operator delete (void* p) noexcept
+{
+  free (p);
+}
+
+int
+main (int argc, char* argv[])
+{
+  return build2::main (argc, argv);
+}
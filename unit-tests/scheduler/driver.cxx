@@ -89,6 +89,10 @@ namespace build2
 
     scheduler s (max_active, 1, 0, queue_depth);
 
+    // Size the wait queue for the number of task counts we will wait on.
+    //
+    s.tune_wait_queue (volume + 1);
+
     // Find # prime counts of primes in [i, d*i*i) ranges for i in (0, n].
     //
     auto outer = [difficulty, &s] (size_t n, vector<uint64_t>& o, uint64_t& r)
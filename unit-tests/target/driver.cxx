@@ -0,0 +1,168 @@
+// file      : unit-tests/target/driver.cxx -*- C++ -*-
+// copyright : Copyright (c) 2014-2019 Code Synthesis Ltd
+// license   : MIT; see accompanying LICENSE file
+
+#include <chrono>
+
+#include <cassert>
+#include <iostream>
+
+#include <build2/types.hxx>
+#include <build2/utility.hxx>
+
+#include <build2/rule.hxx>
+#include <build2/scope.hxx>
+#include <build2/target.hxx>
+#include <build2/context.hxx>
+#include <build2/algorithm.hxx>
+#include <build2/operation.hxx>
+#include <build2/diagnostics.hxx>
+
+using namespace std;
+
+namespace build2
+{
+  // Rule that matches any target and does nothing.
+  //
+  class noop_rule: public rule
+  {
+  public:
+    virtual bool
+    match (action, target&, const string&) const override
+    {
+      return true;
+    }
+
+    virtual recipe
+    apply (action, target&) const override
+    {
+      return noop_recipe;
+    }
+  };
+
+  // Usage argv[0] [-n <targets>] [-d <directories>]
+  //
+  // -n  number of targets to create, for example 500000
+  // -d  number of directories to spread the targets over, for example 1000
+  //
+  // Create file{} targets, verify they can be found, and match a noop rule
+  // to each of them. Then verify that the target arena is released when
+  // the build state is reset. Specifying any option also turns on the
+  // verbose mode in which case the memory used per target as well as the
+  // target creation and match throughput is printed.
+  //
+  int
+  main (int argc, char* argv[])
+  {
+    bool verb (false);
+
+    size_t count (10000);
+    size_t dirs (100);
+
+    for (int i (1); i != argc; ++i)
+    {
+      string a (argv[i]);
+
+      if (a == "-n")
+        count = stoul (argv[++i]);
+      else if (a == "-d")
+        dirs = stoul (argv[++i]);
+      else
+        assert (false);
+
+      verb = true;
+    }
+
+    init (argv[0], 1);  // Fake build system driver, default verbosity.
+    reset (strings ()); // No command line variables.
+
+    tracer trace ("main");
+
+    dir_path root (work / dir_path ("bench"));
+
+    scope& rs (scopes.rw ().insert (root, true)->second);
+
+    noop_rule r;
+    rs.rules.insert<file> (perform_update_id, "bench.noop", r);
+
+    set_current_mif (mo_perform);
+    set_current_oif (op_update);
+
+    using namespace chrono;
+
+    // Create.
+    //
+    vector<const file*> ts;
+    ts.reserve (count);
+
+    size_t m0 (target_set::memory ());
+    auto s (steady_clock::now ());
+
+    for (size_t i (0); i != count; ++i)
+    {
+      dir_path d (root / dir_path ("d" + to_string (i % dirs)));
+
+      ts.push_back (
+        &targets.insert<file> (d, dir_path (), "f" + to_string (i), trace));
+    }
+
+    duration<double> cd (steady_clock::now () - s);
+    size_t m (target_set::memory () - m0);
+
+    assert (targets.size () >= count);
+    assert (m >= count * sizeof (file));
+
+    for (size_t i (0); i != count; i += 1 + count / 100)
+    {
+      const file* t (ts[i]);
+
+      assert (targets.find<file> (t->dir, t->out, t->name) == t);
+    }
+
+    // Match.
+    //
+    action a (perform_update_id);
+    duration<double> md;
+    {
+      phase_lock pl (run_phase::match);
+
+      s = steady_clock::now ();
+
+      for (const file* t: ts)
+      {
+        target_state r (match (a, *t)); // Not inside assert() (NDEBUG).
+        assert (r == target_state::unchanged);
+        (void) r;
+      }
+
+      md = steady_clock::now () - s;
+    }
+
+    if (verb)
+    {
+      auto rate = [count] (const duration<double>& d) -> uint64_t
+      {
+        return d.count () != 0 ? static_cast<uint64_t> (count / d.count ()) : 0;
+      };
+
+      cerr << "targets                " << count                   << endl
+           << "sizeof (file)          " << sizeof (file)           << endl
+           << "arena bytes/target     " << m / count               << endl
+           << "created targets/sec    " << rate (cd)               << endl
+           << "matched targets/sec    " << rate (md)               << endl;
+    }
+
+    // Reset the build state which should release the arena.
+    //
+    reset (strings ());
+    assert (targets.size () == 0 && target_set::memory () == 0);
+
+    return 0;
+  }
+}
+
+int
+main (int argc, char* argv[])
+{
+  return build2::main (argc, argv);
+}
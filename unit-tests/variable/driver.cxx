@@ -0,0 +1,232 @@
+// file      : unit-tests/variable/driver.cxx -*- C++ -*-
+// copyright : Copyright (c) 2014-2019 Code Synthesis Ltd
+// license   : MIT; see accompanying LICENSE file
+
+#include <chrono>
+#include <thread>
+
+#include <cassert>
+#include <iostream>
+
+#include <build2/types.hxx>
+#include <build2/utility.hxx>
+
+#include <build2/scope.hxx>
+#include <build2/target.hxx>
+#include <build2/context.hxx>
+#include <build2/variable.hxx>
+
+using namespace std;
+
+namespace build2
+{
+  // Usage argv[0] [-n <lookups>] [-d <depth>] [-c <variables>]
+  //               [-t <threads>]
+  //
+  // -n  number of lookups to benchmark, for example 10000000
+  // -d  depth of the scope hierarchy, for example 8
+  // -c  number of variables, for example 128
+  // -t  number of threads to perform the cached lookups
+  //
+  // Verify that the cached variable lookups (match phase) produce the same
+  // results as the uncached ones (load phase). Specifying any option also
+  // turns on the verbose mode in which case the number of lookups per second
+  // with and without the cache is printed.
+  //
+  int
+  main (int argc, char* argv[])
+  {
+    bool verb (false);
+
+    size_t lookups (100000);
+    size_t depth (8);
+    size_t count (128);
+    size_t threads (4);
+
+    for (int i (1); i != argc; ++i)
+    {
+      string a (argv[i]);
+
+      if (a == "-n")
+        lookups = stoul (argv[++i]);
+      else if (a == "-d")
+        depth = stoul (argv[++i]);
+      else if (a == "-c")
+        count = stoul (argv[++i]);
+      else if (a == "-t")
+        threads = stoul (argv[++i]);
+      else
+        assert (false);
+
+      verb = true;
+    }
+
+    init (argv[0], 1);  // Fake build system driver, default verbosity.
+    reset (strings ()); // No command line variables.
+
+    // Create the scope hierarchy with the outermost scope being the project
+    // root.
+    //
+    vector<scope*> ss {&scope::global_->rw ()};
+    {
+      dir_path d (work);
+
+      for (size_t i (0); i != depth; ++i)
+      {
+        d /= "d" + to_string (i);
+        ss.push_back (&scopes.rw ().insert (d, i == 0)->second);
+      }
+    }
+
+    // Assign the variables in various scopes leaving some undefined and
+    // also make some of them target type/pattern-specific.
+    //
+    vector<const variable*> vs;
+    {
+      variable_pool& vp (var_pool.rw ());
+
+      for (size_t i (0); i != count; ++i)
+      {
+        const variable& v (vp.insert<uint64_t> ("bench.v" + to_string (i)));
+        vs.push_back (&v);
+
+        if (i % 5 != 0)
+          ss[i % ss.size ()]->assign (v) = uint64_t (i);
+
+        if (i % 7 == 0)
+          ss[(i / 7) % ss.size ()]->target_vars[file::static_type]["f*"]
+            .assign (v) = uint64_t (i);
+      }
+    }
+
+    const scope& bs (*ss.back ());
+    const string tn ("foo");
+    const string gn ("bar"); // Does not match the pattern.
+
+    auto lookup_scope = [&bs] (const variable& v)
+    {
+      return bs.find (v);
+    };
+
+    auto lookup_target = [&bs] (const variable& v, const string& n)
+    {
+      return bs.find (v, &file::static_type, &n);
+    };
+
+    // Uncached (load phase) results.
+    //
+    vector<pair<lookup, size_t>> rs, rt, rg;
+    for (const variable* v: vs)
+    {
+      rs.push_back (lookup_scope (*v));
+      rt.push_back (lookup_target (*v, tn));
+      rg.push_back (lookup_target (*v, gn));
+    }
+
+    auto equal = [] (const pair<lookup, size_t>& x,
+                     const pair<lookup, size_t>& y)
+    {
+      return x.first.value == y.first.value &&
+        x.first.vars == y.first.vars &&
+        x.second == y.second;
+    };
+
+    auto verify = [&] ()
+    {
+      for (size_t i (0); i != vs.size (); ++i)
+      {
+        const variable& v (*vs[i]);
+
+        assert (equal (lookup_scope (v), rs[i]));
+        assert (equal (lookup_target (v, tn), rt[i]));
+        assert (equal (lookup_target (v, gn), rg[i]));
+      }
+    };
+
+    using namespace chrono;
+
+    auto bench = [&vs, &lookup_scope] (size_t n) -> double
+    {
+      auto s (steady_clock::now ());
+
+      size_t c (0);
+      for (size_t i (0); i != n; ++i)
+      {
+        if (lookup_scope (*vs[i % vs.size ()]).first.defined ())
+          ++c;
+      }
+
+      duration<double> d (steady_clock::now () - s);
+      return d.count () != 0 && c != 0 ? n / d.count () : 0;
+    };
+
+    double uncached (verb ? bench (lookups) : 0);
+
+    {
+      phase_lock pl (run_phase::match);
+
+      verify (); // Populate.
+      verify (); // Hit.
+
+      // Concurrent lookups.
+      //
+      vector<thread> ts;
+      for (size_t i (0); i != threads; ++i)
+        ts.push_back (thread (verify));
+
+      for (thread& t: ts)
+        t.join ();
+
+      double cached (verb ? bench (lookups) : 0);
+
+      if (verb)
+        cerr << "scope depth            " << ss.size ()               << endl
+             << "variables              " << vs.size ()               << endl
+             << "uncached lookups/sec   " << static_cast<uint64_t> (uncached)
+             << endl
+             << "cached lookups/sec     " << static_cast<uint64_t> (cached)
+             << endl;
+    }
+
+    // Make sure we are not using stale entries after the load phase.
+    //
+    {
+      phase_lock pl (run_phase::load);
+      ss.front ()->assign (*vs[0]) = uint64_t (0);
+      rs[0] = lookup_scope (*vs[0]);
+      rt[0] = lookup_target (*vs[0], tn);
+      rg[0] = lookup_target (*vs[0], gn);
+    }
+
+    {
+      phase_lock pl (run_phase::match);
+      verify ();
+    }
+
+    // The same but loading more without locking the load phase explicitly,
+    // as the driver does between operation batches (once no phase is locked
+    // it falls back to load).
+    //
+    assert (phase == run_phase::load);
+    {
+      ss.back ()->assign (*vs[1]) = uint64_t (2);
+      rs[1] = lookup_scope (*vs[1]);
+      rt[1] = lookup_target (*vs[1], tn);
+      rg[1] = lookup_target (*vs[1], gn);
+      assert (rs[1].first.defined () && cast<uint64_t> (rs[1].first) == 2);
+    }
+
+    {
+      phase_lock pl (run_phase::match);
+      verify ();
+    }
+
+    return 0;
+  }
+}
+
+int
+main (int argc, char* argv[])
+{
+  return build2::main (argc, argv);
+}